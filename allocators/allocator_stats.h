@@ -0,0 +1,167 @@
+#ifndef FAST_CONTAINERS_ALLOCATOR_STATS_H
+#define FAST_CONTAINERS_ALLOCATOR_STATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace fast_containers::allocators {
+
+    // Instrumentation is opt-in: define FAST_CONTAINERS_ALLOCATOR_STATS for the whole program (e.g. with
+    // add_compile_definitions), otherwise the counters are empty and every call compiles to nothing
+#ifdef FAST_CONTAINERS_ALLOCATOR_STATS
+    inline constexpr bool kAllocatorStatsEnabled = true;
+#else
+    inline constexpr bool kAllocatorStatsEnabled = false;
+#endif
+
+    struct SizeClassStats {
+        std::size_t size_{0};
+        uint64_t allocations_{0};
+        uint64_t deallocations_{0};
+        std::size_t free_list_depth_{0};
+    };
+
+    // Copy of the counters, all zeros if the instrumentation is disabled
+    template<std::size_t ClassesCount>
+    struct AllocatorStatsSnapshot {
+        std::array<SizeClassStats, ClassesCount> size_classes_{};
+        std::size_t live_bytes_{0};
+        std::size_t high_water_bytes_{0};
+        std::size_t mapped_bytes_{0};      // Memory taken from the OS or the upstream
+        uint64_t fallback_allocations_{0}; // Served by the upstream or by the separate mapping
+        uint64_t failed_allocations_{0};   // The class is exhausted or the mapping failed
+    };
+
+
+    // Counters owned by the allocator, must be accessed by the thread that uses the allocator
+    template<std::size_t ClassesCount, bool Enabled = kAllocatorStatsEnabled>
+    class AllocatorStats {
+    public:
+        using Snapshot = AllocatorStatsSnapshot<ClassesCount>;
+
+        void OnAllocate(std::size_t size_class, std::size_t bytes) noexcept;
+        void OnDeallocate(std::size_t size_class, std::size_t bytes) noexcept;
+
+        void OnFreeListPush(std::size_t size_class, std::size_t count = 1) noexcept;
+        void OnFreeListPop(std::size_t size_class, std::size_t count = 1) noexcept;
+
+        void OnMap(std::size_t bytes) noexcept;
+        void OnUnmap(std::size_t bytes) noexcept;
+
+        // Allocations served by the upstream or by the separate mapping, they do not belong to any class
+        void OnFallbackAllocate(std::size_t bytes) noexcept;
+        void OnFallbackDeallocate(std::size_t bytes) noexcept;
+
+        void OnFailure() noexcept;
+
+        // For the allocators that free memory in bulk (e.g. on Reset)
+        void SetLiveBytes(std::size_t bytes) noexcept;
+
+        [[nodiscard]] Snapshot GetSnapshot() const noexcept;
+
+    private:
+        void AddLiveBytes(std::size_t bytes) noexcept;
+
+    private:
+        Snapshot counters_{};
+    };
+
+
+    template<std::size_t ClassesCount>
+    class AllocatorStats<ClassesCount, false> {
+    public:
+        using Snapshot = AllocatorStatsSnapshot<ClassesCount>;
+
+        void OnAllocate(std::size_t, std::size_t) noexcept {}
+        void OnDeallocate(std::size_t, std::size_t) noexcept {}
+
+        void OnFreeListPush(std::size_t, std::size_t = 1) noexcept {}
+        void OnFreeListPop(std::size_t, std::size_t = 1) noexcept {}
+
+        void OnMap(std::size_t) noexcept {}
+        void OnUnmap(std::size_t) noexcept {}
+
+        void OnFallbackAllocate(std::size_t) noexcept {}
+        void OnFallbackDeallocate(std::size_t) noexcept {}
+
+        void OnFailure() noexcept {}
+
+        void SetLiveBytes(std::size_t) noexcept {}
+
+        [[nodiscard]] Snapshot GetSnapshot() const noexcept {
+            return {};
+        }
+    };
+
+
+    // Implementation
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::OnAllocate(std::size_t size_class, std::size_t bytes) noexcept {
+        counters_.size_classes_[size_class].allocations_++;
+        AddLiveBytes(bytes);
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::OnDeallocate(std::size_t size_class, std::size_t bytes) noexcept {
+        counters_.size_classes_[size_class].deallocations_++;
+        counters_.live_bytes_ -= bytes;
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::OnFreeListPush(std::size_t size_class, std::size_t count) noexcept {
+        counters_.size_classes_[size_class].free_list_depth_ += count;
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::OnFreeListPop(std::size_t size_class, std::size_t count) noexcept {
+        counters_.size_classes_[size_class].free_list_depth_ -= count;
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::OnMap(std::size_t bytes) noexcept {
+        counters_.mapped_bytes_ += bytes;
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::OnUnmap(std::size_t bytes) noexcept {
+        counters_.mapped_bytes_ -= bytes;
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::OnFallbackAllocate(std::size_t bytes) noexcept {
+        counters_.fallback_allocations_++;
+        AddLiveBytes(bytes);
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::OnFallbackDeallocate(std::size_t bytes) noexcept {
+        counters_.live_bytes_ -= bytes;
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::OnFailure() noexcept {
+        counters_.failed_allocations_++;
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::SetLiveBytes(std::size_t bytes) noexcept {
+        counters_.live_bytes_ = bytes;
+        counters_.high_water_bytes_ = std::max(counters_.high_water_bytes_, bytes);
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    AllocatorStats<ClassesCount, Enabled>::Snapshot AllocatorStats<ClassesCount, Enabled>::GetSnapshot() const noexcept {
+        return counters_;
+    }
+
+    template<std::size_t ClassesCount, bool Enabled>
+    void AllocatorStats<ClassesCount, Enabled>::AddLiveBytes(std::size_t bytes) noexcept {
+        counters_.live_bytes_ += bytes;
+        counters_.high_water_bytes_ = std::max(counters_.high_water_bytes_, counters_.live_bytes_);
+    }
+
+} // End of namespace fast_containers::allocators
+
+#endif //FAST_CONTAINERS_ALLOCATOR_STATS_H
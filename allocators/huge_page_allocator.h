@@ -1,86 +1,301 @@
 #ifndef FAST_CONTAINERS_HUGE_PAGE_ALLOCATOR_H
 #define FAST_CONTAINERS_HUGE_PAGE_ALLOCATOR_H
 
+#include <new>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unistd.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "allocator_stats.h"
 
 #define MMAP_ACCESS (PROT_READ | PROT_WRITE)
 #define MMAP_TYPE (MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB)
 
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
 namespace fast_containers::allocators {
 
     namespace details::huge_page_allocator {
 
         inline constexpr std::size_t kHugePageSize = 1u << 21u;
+        inline constexpr std::size_t kGiganticPageSize = 1u << 30u;
+
+        inline constexpr int kNoNumaNode = -1;
+        inline constexpr int kMaxNumaNode = 63;
+        inline constexpr int kMpolBind = 2;
 
     }
 
-    template<typename T>
+    // Memory that backs the mapped region
+    enum class HugePageBacking {
+        kHugeTlb1G,   // Explicit 1 GiB pages from the hugetlbfs pool
+        kHugeTlb2M,   // Explicit 2 MiB pages from the hugetlbfs pool
+        kTransparent, // Regular mapping with madvise(MADV_HUGEPAGE), the kernel promotes it to huge pages
+        kRegular,     // Regular 4 KiB pages
+    };
+
+    inline constexpr std::size_t kHugePageBackingsCount = 4;
+
+    // Fallback chain: 1 GiB pages (if page_size_ is 1 GiB) -> 2 MiB pages -> transparent huge pages -> regular pages
+    struct HugePagePolicy {
+        std::size_t page_size_{details::huge_page_allocator::kHugePageSize};
+        bool allow_transparent_{true};
+        bool allow_regular_{true};
+        int numa_node_{details::huge_page_allocator::kNoNumaNode};
+    };
+
+    inline constexpr HugePagePolicy kStrictHugePagePolicy{details::huge_page_allocator::kHugePageSize, false, false};
+    inline constexpr HugePagePolicy kGiganticPagePolicy{details::huge_page_allocator::kGiganticPageSize};
+
+    // Process-wide counters of MapHugePages, all zeros if the instrumentation is disabled
+    struct HugePageStats {
+        std::array<uint64_t, kHugePageBackingsCount> regions_{}; // Mapped regions by HugePageBacking
+        std::size_t mapped_bytes_{0};
+        std::size_t high_water_bytes_{0};
+        uint64_t fallback_allocations_{0}; // Got the smaller pages than the policy asked
+        uint64_t failed_allocations_{0};
+    };
+
+    struct HugePageRegion {
+        void* pointer_{nullptr};
+        std::size_t size_{0};
+        HugePageBacking backing_{HugePageBacking::kRegular};
+        bool numa_bound_{false};
+    };
+
+    // Throws std::bad_alloc if every allowed backing failed
+    HugePageRegion MapHugePages(std::size_t size, const HugePagePolicy& policy = {});
+    void UnmapHugePages(void* pointer, std::size_t size, const HugePagePolicy& policy = {}) noexcept;
+
+    std::size_t GetHugePageSize(std::size_t size, const HugePagePolicy& policy = {}) noexcept;
+
+    const char* ToString(HugePageBacking backing) noexcept;
+
+    HugePageStats GetHugePageStats() noexcept;
+
+
+    template<typename T, HugePagePolicy Policy = HugePagePolicy{}>
     class HugePageAllocator {
     public:
         using value_type = T;
         using pointer = T*;
 
+        template<typename U>
+        struct rebind {
+            using other = HugePageAllocator<U, Policy>;
+        };
+
         HugePageAllocator() = default;
 
         template <typename U>
-        HugePageAllocator(const HugePageAllocator<U>&) noexcept;
-        HugePageAllocator(HugePageAllocator&&) = delete;
+        HugePageAllocator(const HugePageAllocator<U, Policy>&) noexcept;
+        HugePageAllocator(const HugePageAllocator&) = default;
+        HugePageAllocator(HugePageAllocator&&) = default;
         HugePageAllocator& operator=(const HugePageAllocator&);
-        HugePageAllocator& operator=(HugePageAllocator&&) = delete;
+        HugePageAllocator& operator=(HugePageAllocator&&) = default;
 
         pointer allocate(size_t n);
         void deallocate(pointer pointer, size_t n);
-        
+
+        // Backing of the last allocation made by this allocator
+        [[nodiscard]] HugePageBacking GetLastBacking() const noexcept;
+
     private:
-        static size_t GetHugePageSize(size_t n);
+        HugePageBacking last_backing_{HugePageBacking::kRegular};
 
     };
 
-    template <typename T>
-    bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<T>&);
+    template <typename T, HugePagePolicy Policy>
+    bool operator==(const HugePageAllocator<T, Policy>&, const HugePageAllocator<T, Policy>&);
 
-    template <typename T>
-    bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<T>&);
+    template <typename T, HugePagePolicy Policy>
+    bool operator!=(const HugePageAllocator<T, Policy>&, const HugePageAllocator<T, Policy>&);
 
 
     // Implementation
-    template<typename T>
+    namespace details::huge_page_allocator {
+
+        // Mapping is a syscall anyway, so the counters are shared atomics
+        struct HugePageCounters {
+            std::array<std::atomic<uint64_t>, kHugePageBackingsCount> regions_{};
+            std::atomic<std::size_t> mapped_bytes_{0};
+            std::atomic<std::size_t> high_water_bytes_{0};
+            std::atomic<uint64_t> fallback_allocations_{0};
+            std::atomic<uint64_t> failed_allocations_{0};
+        };
+
+        inline HugePageCounters counters;
+
+        inline void CountMapping(const HugePageRegion& region, const HugePagePolicy& policy) noexcept {
+            const auto expected = policy.page_size_ == kGiganticPageSize ? HugePageBacking::kHugeTlb1G : HugePageBacking::kHugeTlb2M;
+            counters.regions_[static_cast<std::size_t>(region.backing_)].fetch_add(1, std::memory_order_relaxed);
+            if (region.backing_ != expected) {
+                counters.fallback_allocations_.fetch_add(1, std::memory_order_relaxed);
+            }
+            const std::size_t mapped = counters.mapped_bytes_.fetch_add(region.size_, std::memory_order_relaxed) + region.size_;
+            std::size_t high_water = counters.high_water_bytes_.load(std::memory_order_relaxed);
+            while (high_water < mapped && !counters.high_water_bytes_.compare_exchange_weak(high_water, mapped, std::memory_order_relaxed)) {}
+        }
+
+        inline void* Map(std::size_t size, int flags) {
+            void* pointer = mmap(nullptr, size, MMAP_ACCESS, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+            return pointer == MAP_FAILED ? nullptr : pointer;
+        }
+
+        // Maps regular pages aligned to the huge page, so the kernel can back the whole region with huge pages
+        inline void* MapAligned(std::size_t size) {
+            auto pointer = static_cast<char*>(Map(size + kHugePageSize, 0));
+            if (!pointer) {
+                return nullptr;
+            }
+            auto aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(pointer) + kHugePageSize - 1u) & ~(kHugePageSize - 1u));
+            if (aligned != pointer) {
+                munmap(pointer, aligned - pointer);
+            }
+            munmap(aligned + size, (pointer + kHugePageSize) - aligned);
+            return aligned;
+        }
+
+        // Must be called before the first touch of the pages
+        inline bool BindToNumaNode(void* pointer, std::size_t size, int node) {
+#ifdef SYS_mbind
+            if (node < 0 || node > kMaxNumaNode) {
+                return false;
+            }
+            unsigned long node_mask = 1ul << node;
+            return syscall(SYS_mbind, pointer, size, kMpolBind, &node_mask, sizeof(node_mask) * 8 + 1, 0) == 0;
+#else
+            return false;
+#endif
+        }
+
+    } // End of namespace fast_containers::allocators::details::huge_page_allocator
+
+    inline HugePageRegion MapHugePages(std::size_t size, const HugePagePolicy& policy) {
+        using namespace details::huge_page_allocator;
+        HugePageRegion region{nullptr, GetHugePageSize(size, policy)};
+
+        if (policy.page_size_ == kGiganticPageSize && (region.pointer_ = Map(region.size_, MAP_HUGETLB | MAP_HUGE_1GB))) {
+            region.backing_ = HugePageBacking::kHugeTlb1G;
+        } else if ((region.pointer_ = Map(region.size_, MAP_HUGETLB | MAP_HUGE_2MB))) {
+            region.backing_ = HugePageBacking::kHugeTlb2M;
+        } else if ((policy.allow_transparent_ || policy.allow_regular_) && (region.pointer_ = MapAligned(region.size_))) {
+            if (policy.allow_transparent_ && madvise(region.pointer_, region.size_, MADV_HUGEPAGE) == 0) {
+                region.backing_ = HugePageBacking::kTransparent;
+            } else if (policy.allow_regular_) {
+                region.backing_ = HugePageBacking::kRegular;
+            } else {
+                munmap(region.pointer_, region.size_);
+                region.pointer_ = nullptr;
+            }
+        }
+
+        if (!region.pointer_) {
+            if constexpr (kAllocatorStatsEnabled) {
+                counters.failed_allocations_.fetch_add(1, std::memory_order_relaxed);
+            }
+            throw std::bad_alloc();
+        }
+        if constexpr (kAllocatorStatsEnabled) {
+            CountMapping(region, policy);
+        }
+        if (policy.numa_node_ != kNoNumaNode) {
+            region.numa_bound_ = BindToNumaNode(region.pointer_, region.size_, policy.numa_node_);
+        }
+        return region;
+    }
+
+    inline void UnmapHugePages(void* pointer, std::size_t size, const HugePagePolicy& policy) noexcept {
+        const std::size_t mapped = GetHugePageSize(size, policy);
+        munmap(pointer, mapped);
+        if constexpr (kAllocatorStatsEnabled) {
+            details::huge_page_allocator::counters.mapped_bytes_.fetch_sub(mapped, std::memory_order_relaxed);
+        }
+    }
+
+    // Every backing maps the same rounded size, so it can be recomputed on unmap
+    inline std::size_t GetHugePageSize(std::size_t size, const HugePagePolicy& policy) noexcept {
+        const std::size_t page_size = policy.page_size_;
+        return (((size ? size - 1u : 0) / page_size) + 1u) * page_size;
+    }
+
+    inline const char* ToString(HugePageBacking backing) noexcept {
+        switch (backing) {
+            case HugePageBacking::kHugeTlb1G:
+                return "hugetlb 1G";
+            case HugePageBacking::kHugeTlb2M:
+                return "hugetlb 2M";
+            case HugePageBacking::kTransparent:
+                return "transparent";
+            case HugePageBacking::kRegular:
+                return "regular";
+        }
+        return "unknown";
+    }
+
+    inline HugePageStats GetHugePageStats() noexcept {
+        using details::huge_page_allocator::counters;
+        HugePageStats stats;
+        for (std::size_t i = 0; i < kHugePageBackingsCount; i++) {
+            stats.regions_[i] = counters.regions_[i].load(std::memory_order_relaxed);
+        }
+        stats.mapped_bytes_ = counters.mapped_bytes_.load(std::memory_order_relaxed);
+        stats.high_water_bytes_ = counters.high_water_bytes_.load(std::memory_order_relaxed);
+        stats.fallback_allocations_ = counters.fallback_allocations_.load(std::memory_order_relaxed);
+        stats.failed_allocations_ = counters.failed_allocations_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+
+    // HugePageAllocator
+    template<typename T, HugePagePolicy Policy>
     template<typename U>
-    HugePageAllocator<T>::HugePageAllocator(const HugePageAllocator<U> &) noexcept {}
+    HugePageAllocator<T, Policy>::HugePageAllocator(const HugePageAllocator<U, Policy> &) noexcept {}
 
-    template<typename T>
-    HugePageAllocator<T>& HugePageAllocator<T>::operator=(const HugePageAllocator &) {
+    template<typename T, HugePagePolicy Policy>
+    HugePageAllocator<T, Policy>& HugePageAllocator<T, Policy>::operator=(const HugePageAllocator &) {
         return *this;
     }
 
-    template<typename T>
-    HugePageAllocator<T>::pointer HugePageAllocator<T>::allocate(size_t n) {
-        auto ptr = static_cast<pointer>(mmap(nullptr, GetHugePageSize(n * sizeof(T)), MMAP_ACCESS, MMAP_TYPE, -1, 0));
-        if (ptr == MAP_FAILED) {
-            throw std::bad_alloc();
-        }
-        return ptr;
+    template<typename T, HugePagePolicy Policy>
+    HugePageAllocator<T, Policy>::pointer HugePageAllocator<T, Policy>::allocate(size_t n) {
+        auto region = MapHugePages(n * sizeof(T), Policy);
+        last_backing_ = region.backing_;
+        return static_cast<pointer>(region.pointer_);
     }
 
-    template<typename T>
-    void HugePageAllocator<T>::deallocate(HugePageAllocator::pointer pointer, size_t n) {
-        munmap(pointer, GetHugePageSize(n));
+    template<typename T, HugePagePolicy Policy>
+    void HugePageAllocator<T, Policy>::deallocate(HugePageAllocator::pointer pointer, size_t n) {
+        UnmapHugePages(pointer, n * sizeof(T), Policy);
     }
 
-    template<typename T>
-    size_t HugePageAllocator<T>::GetHugePageSize(size_t n) {
-        using namespace details::huge_page_allocator;
-        return (((n - 1u) / kHugePageSize) + 1u) * kHugePageSize;
+    template<typename T, HugePagePolicy Policy>
+    HugePageBacking HugePageAllocator<T, Policy>::GetLastBacking() const noexcept {
+        return last_backing_;
     }
 
 
-    template<typename T>
-    bool operator==(const HugePageAllocator <T> &, const HugePageAllocator <T> &) {
+    template<typename T, HugePagePolicy Policy>
+    bool operator==(const HugePageAllocator<T, Policy> &, const HugePageAllocator<T, Policy> &) {
         return true;
     }
 
-    template<typename T>
-    bool operator!=(const HugePageAllocator <T> &, const HugePageAllocator <T> &) {
+    template<typename T, HugePagePolicy Policy>
+    bool operator!=(const HugePageAllocator<T, Policy> &, const HugePageAllocator<T, Policy> &) {
         return false;
     }
 
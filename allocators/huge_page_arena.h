@@ -0,0 +1,337 @@
+#ifndef FAST_CONTAINERS_HUGE_PAGE_ARENA_H
+#define FAST_CONTAINERS_HUGE_PAGE_ARENA_H
+
+#include <new>
+#include <bit>
+#include <array>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <sys/mman.h>
+
+#include "huge_page_allocator.h"
+#include "allocator_stats.h"
+
+namespace fast_containers::allocators {
+
+    namespace details::huge_page_arena {
+
+        using huge_page_allocator::kHugePageSize;
+
+        // Size classes: 16, 32, 48, 64, then 4 classes per power of two (80, 96, 112, 128, 160, ...) up to 1 MiB.
+        // The waste is at most 25%
+        inline constexpr std::size_t kMinAlignment = 16;
+        inline constexpr std::size_t kSubClassesPow = 2;
+        inline constexpr std::size_t kSubClassesCount = 1u << kSubClassesPow;
+        inline constexpr std::size_t kLinearClassesMaxSize = kMinAlignment * kSubClassesCount;
+        inline constexpr std::size_t kMaxSmallSize = 1u << 20u;
+        inline constexpr std::size_t kMaxChunkAlignment = 4096;
+
+        inline constexpr std::size_t kDefaultBlockSize = kHugePageSize;
+
+        struct Node {
+            Node* next_{nullptr};
+        };
+
+        // Stored at the beginning of every mapped block
+        struct BlockHeader {
+            BlockHeader* next_{nullptr};
+            std::size_t size_{0};
+        };
+
+        constexpr std::size_t GetSizeClass(std::size_t size) {
+            if (size <= kLinearClassesMaxSize) {
+                return size ? (size - 1u) / kMinAlignment : 0;
+            }
+            const std::size_t power = std::bit_width(size - 1u) - 1u;
+            const std::size_t step = std::size_t(1) << (power - kSubClassesPow);
+            const std::size_t sub_class = (size - (std::size_t(1) << power) - 1u) / step;
+            return kSubClassesCount + (power - std::bit_width(kLinearClassesMaxSize - 1u)) * kSubClassesCount + sub_class;
+        }
+
+        constexpr std::size_t GetClassSize(std::size_t size_class) {
+            if (size_class < kSubClassesCount) {
+                return (size_class + 1u) * kMinAlignment;
+            }
+            const std::size_t index = size_class - kSubClassesCount;
+            const std::size_t power = std::bit_width(kLinearClassesMaxSize - 1u) + index / kSubClassesCount;
+            const std::size_t step = std::size_t(1) << (power - kSubClassesPow);
+            return (std::size_t(1) << power) + (index % kSubClassesCount + 1u) * step;
+        }
+
+        // Chunks of the class are carved with this alignment, so reused chunks keep it
+        constexpr std::size_t GetClassAlignment(std::size_t size_class) {
+            const std::size_t size = GetClassSize(size_class);
+            return std::min(size & (0u - size), kMaxChunkAlignment);
+        }
+
+        // The smallest class that fits the size and whose chunks are aligned
+        constexpr std::size_t GetSizeClass(std::size_t size, std::size_t alignment) {
+            std::size_t size_class = GetSizeClass(std::max(size, alignment));
+            while (GetClassAlignment(size_class) < alignment) {
+                size_class++;
+            }
+            return size_class;
+        }
+
+        inline constexpr std::size_t kSizeClassesCount = GetSizeClass(kMaxSmallSize) + 1u;
+
+        static_assert(GetClassSize(GetSizeClass(kMaxSmallSize)) == kMaxSmallSize);
+
+    } // End of namespace fast_containers::allocators::details::huge_page_arena
+
+
+    // Reserves huge pages in bulk and carves small and medium allocations out of them.
+    // Freed chunks are kept in the intrusive free list of their size class and are never returned to the OS.
+    // Allocations larger than 1 MiB are mapped separately.
+    // Pages are mapped with the fallbacks of the HugePagePolicy.
+    // Not thread safe
+    class HugePageArena : public std::pmr::memory_resource {
+    private:
+        using Node = details::huge_page_arena::Node;
+        using BlockHeader = details::huge_page_arena::BlockHeader;
+
+    public:
+        using Stats = AllocatorStatsSnapshot<details::huge_page_arena::kSizeClassesCount>;
+
+        explicit HugePageArena(std::size_t reserve = details::huge_page_arena::kDefaultBlockSize,
+                               std::size_t block_size = details::huge_page_arena::kDefaultBlockSize,
+                               const HugePagePolicy& policy = {});
+
+        HugePageArena(const HugePageArena&) = delete;
+        HugePageArena(HugePageArena&&) = delete;
+        HugePageArena& operator=(const HugePageArena&) = delete;
+        HugePageArena& operator=(HugePageArena&&) = delete;
+
+        void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+        void Deallocate(void* pointer, std::size_t size, std::size_t alignment = alignof(std::max_align_t)) noexcept;
+
+        [[nodiscard]] std::size_t GetMappedBytes() const noexcept;
+
+        // Backing of the last mapped block
+        [[nodiscard]] HugePageBacking GetLastBacking() const noexcept;
+
+        // Allocations larger than 1 MiB are counted as fallbacks
+        [[nodiscard]] Stats GetStats() const noexcept;
+
+        ~HugePageArena() override;
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        void* Carve(std::size_t size_class);
+        void MapBlock(std::size_t size);
+
+        void* Map(std::size_t size);
+
+    private:
+        std::array<Node*, details::huge_page_arena::kSizeClassesCount> free_lists_{};
+        char* current_{nullptr};
+        char* end_{nullptr};
+        BlockHeader* blocks_{nullptr};
+        HugePagePolicy policy_;
+        std::size_t block_size_;
+        std::size_t mapped_bytes_{0};
+        HugePageBacking last_backing_{HugePageBacking::kRegular};
+        [[no_unique_address]] AllocatorStats<details::huge_page_arena::kSizeClassesCount> stats_;
+    };
+
+
+    // Rebindable allocator handle for the standard containers
+    template<typename T>
+    class HugePageArenaAllocator {
+    public:
+        using value_type = T;
+        using pointer = T*;
+
+        HugePageArenaAllocator(HugePageArena& arena) noexcept;
+
+        template<typename U>
+        HugePageArenaAllocator(const HugePageArenaAllocator<U>& other) noexcept;
+
+        pointer allocate(std::size_t n);
+        void deallocate(pointer pointer, std::size_t n) noexcept;
+
+        [[nodiscard]] HugePageArena* GetArena() const noexcept;
+
+    private:
+        HugePageArena* arena_;
+    };
+
+    template<typename T, typename U>
+    bool operator==(const HugePageArenaAllocator<T>& lhs, const HugePageArenaAllocator<U>& rhs);
+
+    template<typename T, typename U>
+    bool operator!=(const HugePageArenaAllocator<T>& lhs, const HugePageArenaAllocator<U>& rhs);
+
+
+    // Implementation
+
+    // HugePageArena
+    inline HugePageArena::HugePageArena(std::size_t reserve, std::size_t block_size, const HugePagePolicy& policy)
+            : policy_(policy), block_size_(GetHugePageSize(block_size, policy)) {
+        MapBlock(std::max(reserve, block_size_));
+    }
+
+    inline void* HugePageArena::Allocate(std::size_t size, std::size_t alignment) {
+        using namespace details::huge_page_arena;
+        if (size > kMaxSmallSize || alignment > kMaxChunkAlignment) {
+            void* pointer = Map(size);
+            stats_.OnFallbackAllocate(size);
+            return pointer;
+        }
+
+        const std::size_t size_class = GetSizeClass(size, alignment);
+        Node* head = free_lists_[size_class];
+        if (head) {
+            free_lists_[size_class] = head->next_;
+            stats_.OnFreeListPop(size_class);
+            stats_.OnAllocate(size_class, size);
+            return head;
+        }
+        void* pointer = Carve(size_class);
+        stats_.OnAllocate(size_class, size);
+        return pointer;
+    }
+
+    inline void HugePageArena::Deallocate(void* pointer, std::size_t size, std::size_t alignment) noexcept {
+        using namespace details::huge_page_arena;
+        if (size > kMaxSmallSize || alignment > kMaxChunkAlignment) {
+            const std::size_t mapped = GetHugePageSize(size, policy_);
+            mapped_bytes_ -= mapped;
+            stats_.OnUnmap(mapped);
+            stats_.OnFallbackDeallocate(size);
+            UnmapHugePages(pointer, size, policy_);
+            return;
+        }
+
+        const std::size_t size_class = GetSizeClass(size, alignment);
+        auto node = new(pointer) Node();
+        node->next_ = free_lists_[size_class];
+        free_lists_[size_class] = node;
+        stats_.OnDeallocate(size_class, size);
+        stats_.OnFreeListPush(size_class);
+    }
+
+    inline std::size_t HugePageArena::GetMappedBytes() const noexcept {
+        return mapped_bytes_;
+    }
+
+    inline HugePageBacking HugePageArena::GetLastBacking() const noexcept {
+        return last_backing_;
+    }
+
+    inline HugePageArena::Stats HugePageArena::GetStats() const noexcept {
+        Stats stats = stats_.GetSnapshot();
+        if constexpr (kAllocatorStatsEnabled) {
+            for (std::size_t i = 0; i < stats.size_classes_.size(); i++) {
+                stats.size_classes_[i].size_ = details::huge_page_arena::GetClassSize(i);
+            }
+        }
+        return stats;
+    }
+
+    inline HugePageArena::~HugePageArena() {
+        while (blocks_) {
+            BlockHeader* block = blocks_;
+            blocks_ = block->next_;
+            UnmapHugePages(block, block->size_, policy_);
+        }
+    }
+
+    inline void* HugePageArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+        return Allocate(bytes, alignment);
+    }
+
+    inline void HugePageArena::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+        Deallocate(p, bytes, alignment);
+    }
+
+    inline bool HugePageArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    inline void* HugePageArena::Carve(std::size_t size_class) {
+        using namespace details::huge_page_arena;
+        const std::size_t size = GetClassSize(size_class);
+        const std::size_t alignment = GetClassAlignment(size_class);
+
+        auto aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(current_) + alignment - 1u) & ~(alignment - 1u));
+        if (aligned + size > end_) {
+            MapBlock(block_size_);
+            aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(current_) + alignment - 1u) & ~(alignment - 1u));
+        }
+        current_ = aligned + size;
+        return aligned;
+    }
+
+    inline void HugePageArena::MapBlock(std::size_t size) {
+        using namespace details::huge_page_arena;
+        size = GetHugePageSize(size, policy_);
+
+        auto block = new(Map(size)) BlockHeader();
+        block->next_ = blocks_;
+        block->size_ = size;
+        blocks_ = block;
+
+        // The rest of the previous block is lost, it is smaller than the largest size class
+        current_ = reinterpret_cast<char*>(block) + sizeof(BlockHeader);
+        end_ = reinterpret_cast<char*>(block) + size;
+    }
+
+    inline void* HugePageArena::Map(std::size_t size) {
+        HugePageRegion region;
+        try {
+            region = MapHugePages(size, policy_);
+        } catch (const std::bad_alloc&) {
+            stats_.OnFailure();
+            throw;
+        }
+        mapped_bytes_ += region.size_;
+        stats_.OnMap(region.size_);
+        last_backing_ = region.backing_;
+        return region.pointer_;
+    }
+
+
+    // HugePageArenaAllocator
+    template<typename T>
+    HugePageArenaAllocator<T>::HugePageArenaAllocator(HugePageArena& arena) noexcept : arena_(&arena) {}
+
+    template<typename T>
+    template<typename U>
+    HugePageArenaAllocator<T>::HugePageArenaAllocator(const HugePageArenaAllocator<U>& other) noexcept
+            : arena_(other.GetArena()) {}
+
+    template<typename T>
+    HugePageArenaAllocator<T>::pointer HugePageArenaAllocator<T>::allocate(std::size_t n) {
+        return static_cast<pointer>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    template<typename T>
+    void HugePageArenaAllocator<T>::deallocate(pointer pointer, std::size_t n) noexcept {
+        arena_->Deallocate(pointer, n * sizeof(T), alignof(T));
+    }
+
+    template<typename T>
+    HugePageArena* HugePageArenaAllocator<T>::GetArena() const noexcept {
+        return arena_;
+    }
+
+    template<typename T, typename U>
+    bool operator==(const HugePageArenaAllocator<T>& lhs, const HugePageArenaAllocator<U>& rhs) {
+        return lhs.GetArena() == rhs.GetArena();
+    }
+
+    template<typename T, typename U>
+    bool operator!=(const HugePageArenaAllocator<T>& lhs, const HugePageArenaAllocator<U>& rhs) {
+        return !(lhs == rhs);
+    }
+
+} // End of namespace fast_containers::allocators
+
+#endif //FAST_CONTAINERS_HUGE_PAGE_ARENA_H
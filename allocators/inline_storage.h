@@ -0,0 +1,79 @@
+#ifndef FAST_CONTAINERS_INLINE_STORAGE_H
+#define FAST_CONTAINERS_INLINE_STORAGE_H
+
+#include <array>
+#include <cstddef>
+#include <concepts>
+
+namespace fast_containers::allocators {
+
+    // Fixed array of N elements of T inside the container
+    template<typename T, std::size_t N>
+    class InlineStorage {
+    public:
+        constexpr T* Data() noexcept;
+        constexpr const T* Data() const noexcept;
+
+        constexpr T& operator[](std::size_t index) noexcept;
+        constexpr const T& operator[](std::size_t index) const noexcept;
+
+        static constexpr std::size_t Size() noexcept;
+
+    private:
+        std::array<T, N> data_{};
+    };
+
+
+    // Storage policies of the fixed containers (DHeap, IdObjectPool). The mapped policies are in storage_policy.h,
+    // the file and the shared memory ones are in mapped_file_storage.h
+    struct InlineStoragePolicy {
+        template<typename T, std::size_t N>
+        using Storage = InlineStorage<T, N>;
+    };
+
+    template<typename Policy>
+    concept IsStoragePolicy = requires {
+        typename Policy::template Storage<int, 1>;
+    };
+
+    // Storage that survives the owner and is shared with the readers. The container keeps its state
+    // in the metadata, initializes or recovers the elements in Attach and wraps the changes that the readers
+    // load with TryLoad into BeginWrite and EndWrite, see MappedFileStorage
+    template<typename Storage>
+    concept IsPersistentStorage = requires(Storage& storage) {
+        { storage.GetMetadata() } -> std::same_as<std::byte*>;
+        storage.Attach([] {}, [] {});
+        storage.BeginWrite();
+        storage.EndWrite();
+    };
+
+
+    // Implementation
+    template<typename T, std::size_t N>
+    constexpr T* InlineStorage<T, N>::Data() noexcept {
+        return data_.data();
+    }
+
+    template<typename T, std::size_t N>
+    constexpr const T* InlineStorage<T, N>::Data() const noexcept {
+        return data_.data();
+    }
+
+    template<typename T, std::size_t N>
+    constexpr T& InlineStorage<T, N>::operator[](std::size_t index) noexcept {
+        return data_[index];
+    }
+
+    template<typename T, std::size_t N>
+    constexpr const T& InlineStorage<T, N>::operator[](std::size_t index) const noexcept {
+        return data_[index];
+    }
+
+    template<typename T, std::size_t N>
+    constexpr std::size_t InlineStorage<T, N>::Size() noexcept {
+        return N;
+    }
+
+} // End of namespace fast_containers::allocators
+
+#endif //FAST_CONTAINERS_INLINE_STORAGE_H
@@ -0,0 +1,415 @@
+#ifndef FAST_CONTAINERS_MAPPED_FILE_STORAGE_H
+#define FAST_CONTAINERS_MAPPED_FILE_STORAGE_H
+
+#include <new>
+#include <array>
+#include <string>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <filesystem>
+#include <type_traits>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "hash.h"
+
+namespace fast_containers::allocators {
+
+    namespace details::mapped_file_storage {
+
+        inline constexpr uint64_t kMagic = 0x454c494650414d46ull; // "FMAPFILE"
+        inline constexpr uint32_t kFormatVersion = 2;
+        inline constexpr std::size_t kMetadataSize = 64;
+        inline constexpr std::size_t kHeaderSize = 4096; // The elements start at the next page
+
+        // The first page of the file
+        struct FileHeader {
+            uint64_t magic_;
+            uint32_t format_version_;
+            uint32_t schema_version_;
+            uint64_t element_size_;
+            uint64_t element_alignment_;
+            uint64_t elements_count_;
+            uint32_t open_;     // Set while the file is attached, cleared by the clean shutdown
+            uint32_t checksum_; // CRC32C of the header with the zero checksum, written by the clean shutdown
+            uint64_t sequence_; // Odd while the owner changes the elements
+            std::array<std::byte, kMetadataSize> metadata_;
+        };
+
+        // No padding, the checksum covers every byte
+        static_assert(std::has_unique_object_representations_v<FileHeader>);
+        static_assert(sizeof(FileHeader) <= kHeaderSize);
+
+        inline uint32_t GetChecksum(FileHeader header) noexcept {
+            header.checksum_ = 0;
+            return utils::Crc32c(&header, sizeof(header));
+        }
+
+        [[noreturn]] inline void ThrowSystemError(const std::string& what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+    } // End of namespace fast_containers::allocators::details::mapped_file_storage
+
+    enum class MappedFileState {
+        kCreated,  // New zero filled file
+        kClean,    // The previous owner closed the file, the metadata is consistent
+        kUnclean   // The previous owner crashed, the metadata may be stale
+    };
+
+    enum class MappedFileKind {
+        kFile,        // Regular file, survives the reboot
+        kSharedMemory // POSIX shared memory object (shm_open), the path is its name, e.g. "/orders"
+    };
+
+    enum class MappedFileAccess {
+        kOwner, // The only writer, creates the file if it does not exist
+        kReader // Read-only mapping of the published file, any number of processes
+    };
+
+    // Fixed array of N elements of T in the MAP_SHARED mapping of the file, the same process or the restarted one
+    // attaches to it in O(1). The first page is the versioned header: the layout (sizeof(T), alignof(T), N and
+    // the user schema version) is checked on attach, the CRC32C checksum is written by the clean shutdown.
+    // The owner keeps its state in the 64 bytes of the metadata and is the only process that holds the flock.
+    // The readers in other processes see the elements with no copy once the owner published the header.
+    // Elements must not point outside the file, the addresses differ between the processes and the restarts.
+    // Throws std::system_error if the file can not be opened, locked or mapped and std::runtime_error if the
+    // file has another layout, the header is corrupted or it is not published yet
+    template<typename T, std::size_t N, MappedFileKind Kind = MappedFileKind::kFile>
+    class MappedFileStorage {
+    private:
+        using FileHeader = details::mapped_file_storage::FileHeader;
+
+    public:
+        static constexpr std::size_t kMetadataSize = details::mapped_file_storage::kMetadataSize;
+
+        explicit MappedFileStorage(const std::filesystem::path& path, uint32_t schema_version = 0,
+                                   MappedFileAccess access = MappedFileAccess::kOwner);
+
+        MappedFileStorage(const MappedFileStorage&) = delete;
+        MappedFileStorage(MappedFileStorage&&) = delete;
+        MappedFileStorage& operator=(const MappedFileStorage&) = delete;
+        MappedFileStorage& operator=(MappedFileStorage&&) = delete;
+
+        T* Data() noexcept;
+        const T* Data() const noexcept;
+
+        T& operator[](std::size_t index) noexcept;
+        const T& operator[](std::size_t index) const noexcept;
+
+        static constexpr std::size_t Size() noexcept;
+
+        // The owner state, zero filled in the new file
+        [[nodiscard]] std::byte* GetMetadata() noexcept;
+        [[nodiscard]] MappedFileState GetState() const noexcept;
+        [[nodiscard]] MappedFileAccess GetAccess() const noexcept;
+
+        // Called by the container after the construction. The owner calls initialize() for the created file and
+        // recover() inside the write section for the file of the crashed owner, since the readers may still map it,
+        // then publishes the file. The readers return at once
+        template<typename Initialize, typename Recover>
+        void Attach(Initialize&& initialize, Recover&& recover);
+
+        // Owner only: makes the new file visible to the readers, called after the elements are initialized
+        void Publish() noexcept;
+
+        // Owner only: the seqlock of the changes that the readers load with TryLoad
+        void BeginWrite() noexcept;
+        void EndWrite() noexcept;
+
+        // For the readers: false if the owner was changing the elements during the load
+        [[nodiscard]] bool TryLoad(std::size_t index, T& element) const noexcept;
+
+        // Owner only: writes the dirty pages to the disk, the clean shutdown does it as well
+        void Sync() noexcept;
+
+        ~MappedFileStorage();
+
+    private:
+        static constexpr std::size_t GetFileSize() noexcept;
+
+        static int Open(const std::filesystem::path& path, int flags) noexcept;
+
+        void Map(const std::filesystem::path& path, uint32_t schema_version);
+        void Validate(const std::filesystem::path& path, uint32_t schema_version);
+
+        [[nodiscard]] FileHeader& GetHeader() noexcept;
+        [[nodiscard]] const FileHeader& GetHeader() const noexcept;
+
+    private:
+        int descriptor_{-1};
+        std::byte* mapping_{nullptr};
+        MappedFileState state_{MappedFileState::kCreated};
+        MappedFileAccess access_{MappedFileAccess::kOwner};
+
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "Elements live in the mapped memory without construction");
+        static_assert(alignof(T) <= details::mapped_file_storage::kHeaderSize, "Elements are overaligned");
+    };
+
+    // The pool and the heap with these policies take the path and the access instead of the default constructor
+    struct MappedFileStoragePolicy {
+        template<typename T, std::size_t N>
+        using Storage = MappedFileStorage<T, N, MappedFileKind::kFile>;
+    };
+
+    struct SharedMemoryStoragePolicy {
+        template<typename T, std::size_t N>
+        using Storage = MappedFileStorage<T, N, MappedFileKind::kSharedMemory>;
+    };
+
+    // Removes the shared memory object, the processes that mapped it keep their mappings
+    inline bool RemoveSharedMemory(const std::filesystem::path& name) noexcept {
+        return shm_unlink(name.c_str()) == 0;
+    }
+
+
+    // Implementation
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    MappedFileStorage<T, N, Kind>::MappedFileStorage(const std::filesystem::path& path, uint32_t schema_version,
+                                                     MappedFileAccess access) : access_(access) {
+        using details::mapped_file_storage::ThrowSystemError;
+
+        descriptor_ = Open(path, access == MappedFileAccess::kOwner ? O_RDWR | O_CREAT : O_RDONLY);
+        if (descriptor_ < 0) {
+            ThrowSystemError("open " + path.string());
+        }
+        try {
+            Map(path, schema_version);
+        } catch (...) {
+            if (mapping_) {
+                munmap(mapping_, GetFileSize());
+            }
+            close(descriptor_);
+            throw;
+        }
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    T* MappedFileStorage<T, N, Kind>::Data() noexcept {
+        return std::launder(reinterpret_cast<T*>(mapping_ + details::mapped_file_storage::kHeaderSize));
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    const T* MappedFileStorage<T, N, Kind>::Data() const noexcept {
+        return std::launder(reinterpret_cast<const T*>(mapping_ + details::mapped_file_storage::kHeaderSize));
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    T& MappedFileStorage<T, N, Kind>::operator[](std::size_t index) noexcept {
+        return Data()[index];
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    const T& MappedFileStorage<T, N, Kind>::operator[](std::size_t index) const noexcept {
+        return Data()[index];
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    constexpr std::size_t MappedFileStorage<T, N, Kind>::Size() noexcept {
+        return N;
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    std::byte* MappedFileStorage<T, N, Kind>::GetMetadata() noexcept {
+        return GetHeader().metadata_.data();
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    MappedFileState MappedFileStorage<T, N, Kind>::GetState() const noexcept {
+        return state_;
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    MappedFileAccess MappedFileStorage<T, N, Kind>::GetAccess() const noexcept {
+        return access_;
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    template<typename Initialize, typename Recover>
+    void MappedFileStorage<T, N, Kind>::Attach(Initialize&& initialize, Recover&& recover) {
+        if (access_ == MappedFileAccess::kReader) {
+            return;
+        }
+        switch (state_) {
+            case MappedFileState::kCreated:
+                initialize();
+                break;
+            case MappedFileState::kClean:
+                break;
+            case MappedFileState::kUnclean:
+                BeginWrite();
+                recover();
+                EndWrite();
+                break;
+        }
+        Publish();
+    }
+
+    // The readers check the magic first, so it is stored the last
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    void MappedFileStorage<T, N, Kind>::Publish() noexcept {
+        std::atomic_ref<uint64_t>(GetHeader().magic_).store(details::mapped_file_storage::kMagic,
+                                                              std::memory_order_release);
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    void MappedFileStorage<T, N, Kind>::BeginWrite() noexcept {
+        std::atomic_ref<uint64_t> sequence(GetHeader().sequence_);
+        sequence.store(sequence.load(std::memory_order_relaxed) | 1u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    void MappedFileStorage<T, N, Kind>::EndWrite() noexcept {
+        std::atomic_ref<uint64_t> sequence(GetHeader().sequence_);
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    bool MappedFileStorage<T, N, Kind>::TryLoad(std::size_t index, T& element) const noexcept {
+        static_assert(std::atomic_ref<T>::is_always_lock_free, "The element can not be read atomically");
+
+        auto& header_sequence = const_cast<uint64_t&>(GetHeader().sequence_);
+        const uint64_t sequence = std::atomic_ref<uint64_t>(header_sequence).load(std::memory_order_acquire);
+        if (sequence & 1u) {
+            return false;
+        }
+        element = std::atomic_ref<T>(const_cast<T&>(Data()[index])).load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return std::atomic_ref<uint64_t>(header_sequence).load(std::memory_order_relaxed) == sequence;
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    void MappedFileStorage<T, N, Kind>::Sync() noexcept {
+        msync(mapping_, GetFileSize(), MS_SYNC);
+    }
+
+    // The checksum is written after the data is synced, so a valid checksum means the whole file is consistent
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    MappedFileStorage<T, N, Kind>::~MappedFileStorage() {
+        if (access_ == MappedFileAccess::kReader) {
+            munmap(mapping_, GetFileSize());
+            close(descriptor_);
+            return;
+        }
+        Sync();
+        auto& header = GetHeader();
+        header.open_ = 0;
+        header.checksum_ = details::mapped_file_storage::GetChecksum(header);
+        msync(mapping_, details::mapped_file_storage::kHeaderSize, MS_SYNC);
+        munmap(mapping_, GetFileSize());
+        close(descriptor_);
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    constexpr std::size_t MappedFileStorage<T, N, Kind>::GetFileSize() noexcept {
+        using details::mapped_file_storage::kHeaderSize;
+        return ((kHeaderSize + sizeof(T) * N + kHeaderSize - 1u) / kHeaderSize) * kHeaderSize;
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    int MappedFileStorage<T, N, Kind>::Open(const std::filesystem::path& path, int flags) noexcept {
+        if constexpr (Kind == MappedFileKind::kSharedMemory) {
+            return shm_open(path.c_str(), flags, 0644);
+        } else {
+            return open(path.c_str(), flags | O_CLOEXEC, 0644);
+        }
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    void MappedFileStorage<T, N, Kind>::Map(const std::filesystem::path& path, uint32_t schema_version) {
+        using details::mapped_file_storage::ThrowSystemError;
+
+        const bool owner = access_ == MappedFileAccess::kOwner;
+        // Two owners would corrupt the free lists
+        if (owner && flock(descriptor_, LOCK_EX | LOCK_NB) != 0) {
+            ThrowSystemError("flock " + path.string());
+        }
+
+        struct stat file_stat{};
+        if (fstat(descriptor_, &file_stat) != 0) {
+            ThrowSystemError("fstat " + path.string());
+        }
+        if (!owner && file_stat.st_size == 0) {
+            throw std::runtime_error(path.string() + " is not published yet");
+        }
+        if (file_stat.st_size == 0 && ftruncate(descriptor_, GetFileSize()) != 0) {
+            ThrowSystemError("ftruncate " + path.string());
+        }
+        if (file_stat.st_size != 0 && std::size_t(file_stat.st_size) != GetFileSize()) {
+            throw std::runtime_error(path.string() + " has another size");
+        }
+
+        const int protection = owner ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* mapping = mmap(nullptr, GetFileSize(), protection, MAP_SHARED, descriptor_, 0);
+        if (mapping == MAP_FAILED) {
+            ThrowSystemError("mmap " + path.string());
+        }
+        mapping_ = static_cast<std::byte*>(mapping);
+
+        // The zero magic is left by the owner that crashed before it published the file
+        const uint64_t magic = std::atomic_ref<uint64_t>(GetHeader().magic_).load(std::memory_order_acquire);
+        if (!owner) {
+            if (magic == 0) {
+                throw std::runtime_error(path.string() + " is not published yet");
+            }
+            Validate(path, schema_version);
+        } else if (magic == 0) {
+            auto header = new(mapping_) FileHeader{};
+            header->format_version_ = details::mapped_file_storage::kFormatVersion;
+            header->schema_version_ = schema_version;
+            header->element_size_ = sizeof(T);
+            header->element_alignment_ = alignof(T);
+            header->elements_count_ = N;
+            header->open_ = 1;
+        } else {
+            Validate(path, schema_version);
+            GetHeader().open_ = 1;
+        }
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    void MappedFileStorage<T, N, Kind>::Validate(const std::filesystem::path& path, uint32_t schema_version) {
+        const auto& header = GetHeader();
+        if (header.magic_ != details::mapped_file_storage::kMagic) {
+            throw std::runtime_error(path.string() + " is not a mapped storage file");
+        }
+        if (header.format_version_ != details::mapped_file_storage::kFormatVersion ||
+            header.schema_version_ != schema_version ||
+            header.element_size_ != sizeof(T) ||
+            header.element_alignment_ != alignof(T) ||
+            header.elements_count_ != N) {
+            throw std::runtime_error(path.string() + " has another layout");
+        }
+        if (access_ == MappedFileAccess::kReader) {
+            state_ = MappedFileState::kClean;
+        } else if (header.open_) {
+            state_ = MappedFileState::kUnclean;
+        } else if (header.checksum_ != details::mapped_file_storage::GetChecksum(header)) {
+            throw std::runtime_error(path.string() + " header is corrupted");
+        } else {
+            state_ = MappedFileState::kClean;
+        }
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    details::mapped_file_storage::FileHeader& MappedFileStorage<T, N, Kind>::GetHeader() noexcept {
+        return *std::launder(reinterpret_cast<FileHeader*>(mapping_));
+    }
+
+    template<typename T, std::size_t N, MappedFileKind Kind>
+    const details::mapped_file_storage::FileHeader& MappedFileStorage<T, N, Kind>::GetHeader() const noexcept {
+        return *std::launder(reinterpret_cast<const FileHeader*>(mapping_));
+    }
+
+} // End of namespace fast_containers::allocators
+
+#endif //FAST_CONTAINERS_MAPPED_FILE_STORAGE_H
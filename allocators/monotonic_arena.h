@@ -0,0 +1,373 @@
+#ifndef FAST_CONTAINERS_MONOTONIC_ARENA_H
+#define FAST_CONTAINERS_MONOTONIC_ARENA_H
+
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <memory_resource>
+
+#include "allocator_stats.h"
+
+namespace fast_containers::allocators {
+
+    namespace details::monotonic_arena {
+
+        inline constexpr std::size_t kDefaultInlineSize = 1u << 16u;
+        inline constexpr std::size_t kDefaultBlockSize = 1u << 16u;
+        inline constexpr std::size_t kBlockAlignment = alignof(std::max_align_t);
+
+        // Stored at the beginning of every overflow block
+        struct BlockHeader {
+            BlockHeader* next_{nullptr};
+            std::size_t size_{0};
+        };
+
+        inline char* AlignUp(char* pointer, std::size_t alignment) noexcept {
+            return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(pointer) + alignment - 1u) & ~(alignment - 1u));
+        }
+
+    } // End of namespace fast_containers::allocators::details::monotonic_arena
+
+
+    template<typename T, typename Arena>
+    class MonotonicArenaAllocator;
+
+    template<typename Arena>
+    class ScopedArenaMarker;
+
+
+    // Bump pointer arena for the data that lives for a single event loop iteration.
+    // Deallocation is a no-op, Reset() frees everything in O(1).
+    // Allocations that do not fit into the inline buffer go to the chained overflow blocks. Blocks are taken from
+    // the upstream (e.g. HugePageArena for the huge page backing) once and are reused after Reset().
+    // Not thread safe
+    template<std::size_t InlineSize = details::monotonic_arena::kDefaultInlineSize>
+    class MonotonicArena : public std::pmr::memory_resource {
+    private:
+        using BlockHeader = details::monotonic_arena::BlockHeader;
+
+    public:
+        template<typename U>
+        using Allocator = MonotonicArenaAllocator<U, MonotonicArena>;
+
+        using Stats = AllocatorStatsSnapshot<1>;
+
+        // Position in the arena, allocations made after it are freed by Rewind
+        struct Marker {
+            BlockHeader* block_{nullptr};
+            char* current_{nullptr};
+        };
+
+        explicit MonotonicArena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource(),
+                                std::size_t block_size = details::monotonic_arena::kDefaultBlockSize);
+
+        MonotonicArena(const MonotonicArena&) = delete;
+        MonotonicArena(MonotonicArena&&) = delete;
+        MonotonicArena& operator=(const MonotonicArena&) = delete;
+        MonotonicArena& operator=(MonotonicArena&&) = delete;
+
+        void* Allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+        template<typename T, typename... Args>
+        T* Construct(Args&&... args);
+
+        // Frees every allocation, overflow blocks are kept for the next iteration
+        void Reset() noexcept;
+
+        [[nodiscard]] Marker GetMarker() const noexcept;
+        void Rewind(Marker marker) noexcept;
+
+        // Returns the overflow blocks to the upstream
+        void Release() noexcept;
+
+        [[nodiscard]] std::size_t GetOverflowBytes() const noexcept;
+
+        static constexpr std::size_t GetInlineCapacity() noexcept;
+
+        // Live bytes include the alignment padding and the unused tails of the skipped blocks,
+        // mapped bytes are the overflow bytes
+        [[nodiscard]] Stats GetStats() const noexcept;
+
+        ~MonotonicArena() override;
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        void* AllocateSlow(std::size_t bytes, std::size_t alignment);
+
+        void SetCurrentBlock(BlockHeader* block, char* current) noexcept;
+
+        [[nodiscard]] std::size_t GetUsedBytes() const noexcept;
+
+        static char* GetBlockBegin(BlockHeader* block) noexcept;
+        static char* GetBlockEnd(BlockHeader* block) noexcept;
+
+    private:
+        char* current_{nullptr};
+        char* end_{nullptr};
+        BlockHeader* current_block_{nullptr}; // nullptr is the inline buffer
+        BlockHeader* first_block_{nullptr};
+        std::pmr::memory_resource* upstream_;
+        std::size_t block_size_;
+        std::size_t overflow_bytes_{0};
+        [[no_unique_address]] AllocatorStats<1> stats_;
+
+        std::aligned_storage_t<std::max(InlineSize, std::size_t(1)), details::monotonic_arena::kBlockAlignment> buffer_;
+    };
+
+
+    // Rewinds the arena to the position at the construction, e.g. for nested phases of the iteration
+    template<typename Arena>
+    class ScopedArenaMarker {
+    public:
+        explicit ScopedArenaMarker(Arena& arena) noexcept;
+
+        ScopedArenaMarker(const ScopedArenaMarker&) = delete;
+        ScopedArenaMarker(ScopedArenaMarker&&) = delete;
+        ScopedArenaMarker& operator=(const ScopedArenaMarker&) = delete;
+        ScopedArenaMarker& operator=(ScopedArenaMarker&&) = delete;
+
+        ~ScopedArenaMarker();
+
+    private:
+        Arena& arena_;
+        typename Arena::Marker marker_;
+    };
+
+
+    // Rebindable allocator handle for the standard containers, deallocate is a no-op
+    template<typename T, typename Arena>
+    class MonotonicArenaAllocator {
+    public:
+        using value_type = T;
+        using pointer = T*;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        MonotonicArenaAllocator(Arena& arena) noexcept;
+
+        template<typename U>
+        MonotonicArenaAllocator(const MonotonicArenaAllocator<U, Arena>& other) noexcept;
+
+        pointer allocate(std::size_t n);
+        void deallocate(pointer, std::size_t) noexcept {}
+
+        [[nodiscard]] Arena* GetArena() const noexcept;
+
+    private:
+        Arena* arena_;
+    };
+
+    template<typename T, typename U, typename Arena>
+    bool operator==(const MonotonicArenaAllocator<T, Arena>& lhs, const MonotonicArenaAllocator<U, Arena>& rhs);
+
+    template<typename T, typename U, typename Arena>
+    bool operator!=(const MonotonicArenaAllocator<T, Arena>& lhs, const MonotonicArenaAllocator<U, Arena>& rhs);
+
+
+    // Implementation
+
+    // MonotonicArena
+    template<std::size_t InlineSize>
+    MonotonicArena<InlineSize>::MonotonicArena(std::pmr::memory_resource* upstream, std::size_t block_size)
+            : upstream_(upstream), block_size_(block_size) {
+        Reset();
+    }
+
+    template<std::size_t InlineSize>
+    void* MonotonicArena<InlineSize>::Allocate(std::size_t bytes, std::size_t alignment) {
+        char* aligned = details::monotonic_arena::AlignUp(current_, alignment);
+        if (aligned + bytes <= end_) [[likely]] {
+            stats_.OnAllocate(0, aligned + bytes - current_);
+            current_ = aligned + bytes;
+            return aligned;
+        }
+        return AllocateSlow(bytes, alignment);
+    }
+
+    template<std::size_t InlineSize>
+    template<typename T, typename... Args>
+    T* MonotonicArena<InlineSize>::Construct(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "Destructors are not called by the arena");
+        return new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template<std::size_t InlineSize>
+    void MonotonicArena<InlineSize>::Reset() noexcept {
+        current_block_ = nullptr;
+        current_ = reinterpret_cast<char*>(&buffer_);
+        end_ = current_ + InlineSize;
+        stats_.SetLiveBytes(0);
+    }
+
+    template<std::size_t InlineSize>
+    MonotonicArena<InlineSize>::Marker MonotonicArena<InlineSize>::GetMarker() const noexcept {
+        return {current_block_, current_};
+    }
+
+    template<std::size_t InlineSize>
+    void MonotonicArena<InlineSize>::Rewind(Marker marker) noexcept {
+        SetCurrentBlock(marker.block_, marker.current_);
+        if constexpr (kAllocatorStatsEnabled) {
+            stats_.SetLiveBytes(GetUsedBytes());
+        }
+    }
+
+    template<std::size_t InlineSize>
+    void MonotonicArena<InlineSize>::Release() noexcept {
+        Reset();
+        while (first_block_) {
+            BlockHeader* block = first_block_;
+            first_block_ = block->next_;
+            upstream_->deallocate(block, block->size_, details::monotonic_arena::kBlockAlignment);
+        }
+        stats_.OnUnmap(overflow_bytes_);
+        overflow_bytes_ = 0;
+    }
+
+    template<std::size_t InlineSize>
+    std::size_t MonotonicArena<InlineSize>::GetOverflowBytes() const noexcept {
+        return overflow_bytes_;
+    }
+
+    template<std::size_t InlineSize>
+    constexpr std::size_t MonotonicArena<InlineSize>::GetInlineCapacity() noexcept {
+        return InlineSize;
+    }
+
+    template<std::size_t InlineSize>
+    MonotonicArena<InlineSize>::Stats MonotonicArena<InlineSize>::GetStats() const noexcept {
+        return stats_.GetSnapshot();
+    }
+
+    template<std::size_t InlineSize>
+    MonotonicArena<InlineSize>::~MonotonicArena() {
+        Release();
+    }
+
+    template<std::size_t InlineSize>
+    void* MonotonicArena<InlineSize>::do_allocate(std::size_t bytes, std::size_t alignment) {
+        return Allocate(bytes, alignment);
+    }
+
+    template<std::size_t InlineSize>
+    void MonotonicArena<InlineSize>::do_deallocate(void*, std::size_t, std::size_t) {}
+
+    template<std::size_t InlineSize>
+    bool MonotonicArena<InlineSize>::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    // Moves to the next overflow block that fits the allocation, the upstream is called only if there is no one
+    template<std::size_t InlineSize>
+    void* MonotonicArena<InlineSize>::AllocateSlow(std::size_t bytes, std::size_t alignment) {
+        using namespace details::monotonic_arena;
+        BlockHeader* previous = current_block_;
+        BlockHeader* block = current_block_ ? current_block_->next_ : first_block_;
+        while (block && AlignUp(GetBlockBegin(block), alignment) + bytes > GetBlockEnd(block)) {
+            previous = block;
+            block = block->next_;
+        }
+
+        if (!block) {
+            const std::size_t size = std::max(block_size_, sizeof(BlockHeader) + bytes + alignment);
+            block = new(upstream_->allocate(size, kBlockAlignment)) BlockHeader();
+            block->size_ = size;
+            overflow_bytes_ += size;
+            stats_.OnMap(size);
+            if (previous) {
+                previous->next_ = block;
+            } else {
+                first_block_ = block;
+            }
+        }
+
+        SetCurrentBlock(block, GetBlockBegin(block));
+        char* aligned = AlignUp(current_, alignment);
+        current_ = aligned + bytes;
+        if constexpr (kAllocatorStatsEnabled) {
+            stats_.OnAllocate(0, 0);
+            stats_.SetLiveBytes(GetUsedBytes());
+        }
+        return aligned;
+    }
+
+    template<std::size_t InlineSize>
+    void MonotonicArena<InlineSize>::SetCurrentBlock(BlockHeader* block, char* current) noexcept {
+        current_block_ = block;
+        current_ = current;
+        end_ = block ? GetBlockEnd(block) : reinterpret_cast<char*>(&buffer_) + InlineSize;
+    }
+
+    // Blocks before the current one are counted as full
+    template<std::size_t InlineSize>
+    std::size_t MonotonicArena<InlineSize>::GetUsedBytes() const noexcept {
+        if (!current_block_) {
+            return current_ - reinterpret_cast<const char*>(&buffer_);
+        }
+        std::size_t result = InlineSize;
+        for (BlockHeader* block = first_block_; block != current_block_; block = block->next_) {
+            result += block->size_ - sizeof(BlockHeader);
+        }
+        return result + (current_ - GetBlockBegin(current_block_));
+    }
+
+    template<std::size_t InlineSize>
+    char* MonotonicArena<InlineSize>::GetBlockBegin(BlockHeader* block) noexcept {
+        return reinterpret_cast<char*>(block) + sizeof(BlockHeader);
+    }
+
+    template<std::size_t InlineSize>
+    char* MonotonicArena<InlineSize>::GetBlockEnd(BlockHeader* block) noexcept {
+        return reinterpret_cast<char*>(block) + block->size_;
+    }
+
+
+    // ScopedArenaMarker
+    template<typename Arena>
+    ScopedArenaMarker<Arena>::ScopedArenaMarker(Arena& arena) noexcept : arena_(arena), marker_(arena.GetMarker()) {}
+
+    template<typename Arena>
+    ScopedArenaMarker<Arena>::~ScopedArenaMarker() {
+        arena_.Rewind(marker_);
+    }
+
+
+    // MonotonicArenaAllocator
+    template<typename T, typename Arena>
+    MonotonicArenaAllocator<T, Arena>::MonotonicArenaAllocator(Arena& arena) noexcept : arena_(&arena) {}
+
+    template<typename T, typename Arena>
+    template<typename U>
+    MonotonicArenaAllocator<T, Arena>::MonotonicArenaAllocator(const MonotonicArenaAllocator<U, Arena>& other) noexcept
+            : arena_(other.GetArena()) {}
+
+    template<typename T, typename Arena>
+    MonotonicArenaAllocator<T, Arena>::pointer MonotonicArenaAllocator<T, Arena>::allocate(std::size_t n) {
+        return static_cast<pointer>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    template<typename T, typename Arena>
+    Arena* MonotonicArenaAllocator<T, Arena>::GetArena() const noexcept {
+        return arena_;
+    }
+
+    template<typename T, typename U, typename Arena>
+    bool operator==(const MonotonicArenaAllocator<T, Arena>& lhs, const MonotonicArenaAllocator<U, Arena>& rhs) {
+        return lhs.GetArena() == rhs.GetArena();
+    }
+
+    template<typename T, typename U, typename Arena>
+    bool operator!=(const MonotonicArenaAllocator<T, Arena>& lhs, const MonotonicArenaAllocator<U, Arena>& rhs) {
+        return !(lhs == rhs);
+    }
+
+} // End of namespace fast_containers::allocators
+
+#endif //FAST_CONTAINERS_MONOTONIC_ARENA_H
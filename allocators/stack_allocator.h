@@ -1,55 +1,122 @@
 #ifndef FAST_CONTAINERS_STACK_ALLOCATOR_H
 #define FAST_CONTAINERS_STACK_ALLOCATOR_H
 
+#include <new>
 #include <bit>
+#include <array>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
 #include <type_traits>
-#include "common.h"
+#include <memory_resource>
+
+#include "allocator_stats.h"
 
 namespace fast_containers::allocators {
 
+    inline constexpr std::size_t kUnlimitedChunks = std::numeric_limits<std::size_t>::max();
+
+    // Chunks of the class contain elements_ elements of T, at most max_chunks_ of them are carved from the buffer
+    struct StackSizeClass {
+        std::size_t elements_{1};
+        std::size_t max_chunks_{kUnlimitedChunks};
+    };
+
+    template<std::size_t N>
+    using StackSizeClasses = std::array<StackSizeClass, N>;
+
+    // 1, 2, 4, ..., bit_ceil(MaxN) elements
+    template<std::size_t MaxN>
+    constexpr auto MakePowerOfTwoSizeClasses();
+
+    // SubClasses classes per power of two, e.g. 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, ... (x1.25 steps)
+    template<std::size_t MaxN, std::size_t SubClasses = 4>
+    constexpr auto MakeGeometricSizeClasses();
+
     namespace details::chunk_stack_based_allocator {
 
+        inline constexpr std::size_t kDefaultMaxN = 1024;
+
+        // Larger tables are searched with the binary search
+        inline constexpr std::size_t kMaxLookupElements = 4096;
+
         struct Node {
             Node* next_{nullptr};
         };
 
         template<typename T>
         concept IsStorable = sizeof(T) >= sizeof(Node) && (alignof(T) % alignof(Node) == 0);
-    }
 
-    template<typename T, ContainerCapacity TotalN, size_t MaxN = 1024>
-    requires details::chunk_stack_based_allocator::IsStorable<T>
-    class StackBasedAllocator;
+        template<typename T>
+        inline constexpr bool kIsSizeClasses = false;
+
+        template<std::size_t N>
+        inline constexpr bool kIsSizeClasses<StackSizeClasses<N>> = N > 0;
+
+        // Either MaxN of the power of two classes or the table of the classes
+        template<auto SizeClasses>
+        concept IsSizeClassesSpec = std::is_integral_v<decltype(SizeClasses)> ||
+                                    kIsSizeClasses<std::remove_cv_t<decltype(SizeClasses)>>;
+
+        template<auto SizeClasses>
+        constexpr auto GetSizeClasses() {
+            if constexpr (std::is_integral_v<decltype(SizeClasses)>) {
+                return MakePowerOfTwoSizeClasses<SizeClasses>();
+            } else {
+                return SizeClasses;
+            }
+        }
 
-    namespace details::chunk_stack_based_allocator {
+        template<std::size_t N>
+        constexpr bool AreValid(const StackSizeClasses<N>& size_classes) {
+            for (std::size_t i = 0; i < N; i++) {
+                if (size_classes[i].elements_ == 0 || size_classes[i].max_chunks_ == 0 ||
+                    (i && size_classes[i - 1].elements_ >= size_classes[i].elements_)) {
+                    return false;
+                }
+            }
+            return N <= std::numeric_limits<uint8_t>::max();
+        }
+
+        constexpr std::size_t GetNextGeometricSize(std::size_t elements, std::size_t sub_classes) {
+            return elements + std::max(std::bit_floor(elements) / sub_classes, std::size_t(1));
+        }
+
+        // Index of the smallest class for every elements count
+        template<std::size_t N, StackSizeClasses<N> SizeClasses>
+        constexpr auto MakeLookupTable() {
+            std::array<uint8_t, SizeClasses[N - 1].elements_ + 1u> result{};
+            std::size_t size_class = 0;
+            for (std::size_t elements = 1; elements < result.size(); elements++) {
+                while (SizeClasses[size_class].elements_ < elements) {
+                    size_class++;
+                }
+                result[elements] = static_cast<uint8_t>(size_class);
+            }
+            return result;
+        }
 
         template<typename T>
         class ChunkStackBasedAllocator {
         public:
-            ChunkStackBasedAllocator() = default;
+            using Pointer = T*;
 
-            template<typename Storage>
-            ChunkStackBasedAllocator(Storage* storage, ContainerCapacity index, ChunkCapacity chunk_capacity, size_t chunks_count);
+            ChunkStackBasedAllocator() = default;
 
             ChunkStackBasedAllocator(ChunkStackBasedAllocator&& other) noexcept;
             ChunkStackBasedAllocator& operator=(ChunkStackBasedAllocator&& other) noexcept;
 
-            void Clear();
-
-            template<typename _T, ContainerCapacity TotalN, size_t MaxN>
-            requires details::chunk_stack_based_allocator::IsStorable<_T>
-            friend class fast_containers::allocators::StackBasedAllocator;
-
-        public:
-            using Pointer = T*;
-
             ChunkStackBasedAllocator(const ChunkStackBasedAllocator&) = delete;
             ChunkStackBasedAllocator& operator=(const ChunkStackBasedAllocator&) = delete;
 
-            Pointer Allocate();
-            void Deallocate(Pointer pointer);
+            void Clear();
+
+            // Returns nullptr if the free list is empty
+            Pointer Allocate() noexcept;
+            void Deallocate(Pointer pointer) noexcept;
 
-            ~ChunkStackBasedAllocator();
+            ~ChunkStackBasedAllocator() = default;
 
         private:
             Node* list_head_{nullptr};
@@ -57,131 +124,325 @@ namespace fast_containers::allocators {
 
     } // End of namespace fast_containers::allocators::details::chunk_stack_based_allocator
 
+    template<typename T, std::size_t TotalN, auto SizeClasses = details::chunk_stack_based_allocator::kDefaultMaxN>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    class StackBasedMemoryResource;
 
-    template<typename T, ContainerCapacity TotalN, size_t MaxN>
-    requires details::chunk_stack_based_allocator::IsStorable<T>
-    class StackBasedAllocator {
+    template<typename T, typename Resource>
+    class StackBasedAllocator;
+
+
+    // Memory resource over the inplace buffer of TotalN elements of T. SizeClasses is either MaxN of the power of two
+    // classes or the table of StackSizeClass. Chunks are carved from the buffer by the bump pointer on demand,
+    // so only the used part of the buffer is touched. Freed chunks go to the free list of their class.
+    // Requests larger than the largest class, with the extended alignment, from the class that reached its budget
+    // or when the buffer is exhausted go to the upstream
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    class StackBasedMemoryResource : public std::pmr::memory_resource {
     private:
         using Node = details::chunk_stack_based_allocator::Node;
         using ChunkAllocator = details::chunk_stack_based_allocator::ChunkStackBasedAllocator<T>;
 
+        static constexpr auto kSizeClasses = details::chunk_stack_based_allocator::GetSizeClasses<SizeClasses>();
+        static constexpr std::size_t kSizeClassesCount = kSizeClasses.size();
+        static constexpr std::size_t kMaxElements = kSizeClasses[kSizeClassesCount - 1u].elements_;
+        static constexpr std::size_t kBufferSize = TotalN * sizeof(T);
+
+        static_assert(TotalN > 0, "The buffer is empty");
+        static_assert(details::chunk_stack_based_allocator::AreValid(kSizeClasses),
+                      "Size classes must be non-empty, strictly increasing and at most 255");
+
+    public:
+        template<typename U>
+        using Allocator = StackBasedAllocator<U, StackBasedMemoryResource>;
+
+        using Stats = AllocatorStatsSnapshot<kSizeClassesCount>;
+
+        explicit StackBasedMemoryResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+        StackBasedMemoryResource(const StackBasedMemoryResource&) = delete;
+        StackBasedMemoryResource(StackBasedMemoryResource&&) = delete;
+        StackBasedMemoryResource& operator=(const StackBasedMemoryResource&) = delete;
+        StackBasedMemoryResource& operator=(StackBasedMemoryResource&& other) = delete;
+
+        void* Allocate(std::size_t bytes, std::size_t alignment = alignof(T));
+        void Deallocate(void* pointer, std::size_t bytes, std::size_t alignment = alignof(T)) noexcept;
+
+        [[nodiscard]] bool Owns(const void* pointer) const noexcept;
+
+        [[nodiscard]] std::pmr::memory_resource* GetUpstream() const noexcept;
+
+        // Part of the buffer already carved into chunks
+        [[nodiscard]] std::size_t GetCarvedBytes() const noexcept;
+
+        // Requests that are not served by the buffer are counted as failures, the upstream requests as fallbacks
+        [[nodiscard]] Stats GetStats() const noexcept;
+
+        ~StackBasedMemoryResource() override = default;
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        // Returns kSizeClassesCount if the bytes do not fit into the largest class
+        static std::size_t GetChunkAllocatorIndex(std::size_t bytes) noexcept;
+
+        void* Carve(std::size_t index) noexcept;
+
+    private:
+        // Not initialized, the pages are touched only when the chunks are carved
+        std::aligned_storage_t<kBufferSize, alignof(T)> buffer_;
+        std::array<ChunkAllocator, kSizeClassesCount> chunk_allocators_{};
+        std::array<std::size_t, kSizeClassesCount> carved_chunks_{};
+        char* current_;
+        std::pmr::memory_resource* upstream_;
+        [[no_unique_address]] AllocatorStats<kSizeClassesCount> stats_;
+
+    };
+
+
+    // Rebindable allocator handle for the standard containers, the calls to the resource are not virtual
+    template<typename T, typename Resource>
+    class StackBasedAllocator {
     public:
         using value_type = T;
         using pointer = T*;
+        using propagate_on_container_copy_assignment = std::true_type;
         using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
 
-        StackBasedAllocator();
+        StackBasedAllocator(Resource& resource) noexcept;
 
-        StackBasedAllocator(const StackBasedAllocator&) = delete;
-        StackBasedAllocator(StackBasedAllocator&&) = delete;
-        StackBasedAllocator& operator=(const StackBasedAllocator&) = delete;
-        StackBasedAllocator& operator=(StackBasedAllocator&& other) = delete;
+        template<typename U>
+        StackBasedAllocator(const StackBasedAllocator<U, Resource>& other) noexcept;
 
-        pointer allocate(size_t n);
-        void deallocate(pointer pointer, size_t n);
+        pointer allocate(std::size_t n);
+        void deallocate(pointer pointer, std::size_t n) noexcept;
 
-        ~StackBasedAllocator();
+        [[nodiscard]] Resource* GetResource() const noexcept;
 
     private:
-        void Clear();
+        Resource* resource_;
+    };
 
-        size_t GetChunkAllocatorIndex(size_t n);
+    template<typename T, typename U, typename Resource>
+    bool operator==(const StackBasedAllocator<T, Resource>& lhs, const StackBasedAllocator<U, Resource>& rhs);
 
-        static constexpr size_t GetBufferSize();
-        static constexpr size_t GetChunkAllocatorsNumber();
+    template<typename T, typename U, typename Resource>
+    bool operator!=(const StackBasedAllocator<T, Resource>& lhs, const StackBasedAllocator<U, Resource>& rhs);
 
-    private:
-        std::aligned_storage_t<GetBufferSize(), alignof(T)> buffer_{};
-        std::array<ChunkAllocator, GetChunkAllocatorsNumber()> chunk_allocators_;
 
-    };
+    //Implementation
 
+    template<std::size_t MaxN>
+    constexpr auto MakePowerOfTwoSizeClasses() {
+        StackSizeClasses<std::countr_zero(std::bit_ceil(MaxN)) + 1u> result{};
+        for (std::size_t i = 0; i < result.size(); i++) {
+            result[i].elements_ = std::size_t(1) << i;
+        }
+        return result;
+    }
 
-    //Implementation
+    template<std::size_t MaxN, std::size_t SubClasses>
+    constexpr auto MakeGeometricSizeClasses() {
+        using details::chunk_stack_based_allocator::GetNextGeometricSize;
+        constexpr std::size_t count = []() {
+            std::size_t result = 1;
+            for (std::size_t elements = 1; elements < MaxN; elements = GetNextGeometricSize(elements, SubClasses)) {
+                result++;
+            }
+            return result;
+        }();
+
+        StackSizeClasses<count> result{};
+        std::size_t elements = 1;
+        for (std::size_t i = 0; i < count; i++) {
+            result[i].elements_ = elements;
+            elements = GetNextGeometricSize(elements, SubClasses);
+        }
+        return result;
+    }
 
-    template<typename T, ContainerCapacity TotalN, size_t MaxN>
-    requires details::chunk_stack_based_allocator::IsStorable<T>
-    StackBasedAllocator<T, TotalN, MaxN>::StackBasedAllocator() {
-        size_t index = 0;
-        for (int i = 0; i < GetChunkAllocatorsNumber(); i++) {
-            size_t chunk_capacity = 1u << i;
-            size_t chunks_count = (TotalN / chunk_capacity) + 1;
 
-            chunk_allocators_[i] = ChunkAllocator(&buffer_, index, chunk_capacity, chunks_count);
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    StackBasedMemoryResource<T, TotalN, SizeClasses>::StackBasedMemoryResource(std::pmr::memory_resource* upstream)
+            : current_(reinterpret_cast<char*>(&buffer_)), upstream_(upstream) {}
+
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    void* StackBasedMemoryResource<T, TotalN, SizeClasses>::Allocate(std::size_t bytes, std::size_t alignment) {
+        const std::size_t index = GetChunkAllocatorIndex(bytes);
+        if (index < kSizeClassesCount && alignment <= alignof(T)) {
+            if (auto pointer = chunk_allocators_[index].Allocate()) {
+                stats_.OnFreeListPop(index);
+                stats_.OnAllocate(index, bytes);
+                return pointer;
+            }
+            if (auto pointer = Carve(index)) {
+                stats_.OnAllocate(index, bytes);
+                return pointer;
+            }
+            stats_.OnFailure();
+        }
+        void* pointer = upstream_->allocate(bytes, alignment);
+        stats_.OnFallbackAllocate(bytes);
+        return pointer;
+    }
 
-            index += chunks_count * chunk_capacity * sizeof(T);
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    void StackBasedMemoryResource<T, TotalN, SizeClasses>::Deallocate(void* pointer, std::size_t bytes, std::size_t alignment) noexcept {
+        if (Owns(pointer)) {
+            const std::size_t index = GetChunkAllocatorIndex(bytes);
+            chunk_allocators_[index].Deallocate(static_cast<T*>(pointer));
+            stats_.OnDeallocate(index, bytes);
+            stats_.OnFreeListPush(index);
+        } else {
+            upstream_->deallocate(pointer, bytes, alignment);
+            stats_.OnFallbackDeallocate(bytes);
         }
     }
 
-    template<typename T, ContainerCapacity TotalN, size_t MaxN>
-    requires details::chunk_stack_based_allocator::IsStorable<T>
-    StackBasedAllocator<T, TotalN, MaxN>::pointer StackBasedAllocator<T, TotalN, MaxN>::allocate(size_t n) {
-        return chunk_allocators_[GetChunkAllocatorIndex(n)].Allocate();
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    bool StackBasedMemoryResource<T, TotalN, SizeClasses>::Owns(const void* pointer) const noexcept {
+        const auto address = reinterpret_cast<uintptr_t>(pointer);
+        const auto begin = reinterpret_cast<uintptr_t>(&buffer_);
+        return address >= begin && address < begin + kBufferSize;
     }
 
-    template<typename T, ContainerCapacity TotalN, size_t MaxN>
-    requires details::chunk_stack_based_allocator::IsStorable<T>
-    void StackBasedAllocator<T, TotalN, MaxN>::deallocate(StackBasedAllocator::pointer pointer, size_t n) {
-        return chunk_allocators_[GetChunkAllocatorIndex(n)].Deallocate(pointer);
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    std::pmr::memory_resource* StackBasedMemoryResource<T, TotalN, SizeClasses>::GetUpstream() const noexcept {
+        return upstream_;
     }
 
-    template<typename T, ContainerCapacity TotalN, size_t MaxN>
-    requires details::chunk_stack_based_allocator::IsStorable<T>
-    StackBasedAllocator<T, TotalN, MaxN>::~StackBasedAllocator() {
-        Clear();
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    std::size_t StackBasedMemoryResource<T, TotalN, SizeClasses>::GetCarvedBytes() const noexcept {
+        return current_ - reinterpret_cast<const char*>(&buffer_);
     }
 
-    template<typename T, ContainerCapacity TotalN, size_t MaxN>
-    requires details::chunk_stack_based_allocator::IsStorable<T>
-    void StackBasedAllocator<T, TotalN, MaxN>::Clear() {
-        for (int i = 0; i < GetChunkAllocatorsNumber(); i++) {
-            //chunk_allocators_[i].Clear();
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    StackBasedMemoryResource<T, TotalN, SizeClasses>::Stats StackBasedMemoryResource<T, TotalN, SizeClasses>::GetStats() const noexcept {
+        Stats stats = stats_.GetSnapshot();
+        if constexpr (kAllocatorStatsEnabled) {
+            for (std::size_t i = 0; i < kSizeClassesCount; i++) {
+                stats.size_classes_[i].size_ = kSizeClasses[i].elements_ * sizeof(T);
+            }
         }
+        return stats;
+    }
+
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    void* StackBasedMemoryResource<T, TotalN, SizeClasses>::do_allocate(std::size_t bytes, std::size_t alignment) {
+        return Allocate(bytes, alignment);
+    }
+
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    void StackBasedMemoryResource<T, TotalN, SizeClasses>::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+        Deallocate(p, bytes, alignment);
     }
 
-    template<typename T, ContainerCapacity TotalN, size_t MaxN>
-    requires details::chunk_stack_based_allocator::IsStorable<T>size_t
-    StackBasedAllocator<T, TotalN, MaxN>::GetChunkAllocatorIndex(size_t n) {
-        return __builtin_ctz(std::bit_ceil(n));
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    bool StackBasedMemoryResource<T, TotalN, SizeClasses>::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
     }
 
-    template<typename T, ContainerCapacity TotalN, size_t MaxN>
-    requires details::chunk_stack_based_allocator::IsStorable<T>
-    constexpr size_t StackBasedAllocator<T, TotalN, MaxN>::GetBufferSize() {
-        size_t chunks_number = GetChunkAllocatorsNumber();
-        size_t result = 0;
-        for (size_t i = 0; i < chunks_number; i++) {
-            size_t chunk_capacity = 1u << i;
-            size_t chunks_count = (TotalN / chunk_capacity) + 1;
-            result += chunks_count * chunk_capacity * sizeof(T);
+    // Index of the smallest class that fits the bytes, the lookup table is used for the small tables
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    std::size_t StackBasedMemoryResource<T, TotalN, SizeClasses>::GetChunkAllocatorIndex(std::size_t bytes) noexcept {
+        using namespace details::chunk_stack_based_allocator;
+        const std::size_t n = (bytes + sizeof(T) - 1u) / sizeof(T);
+        if (n > kMaxElements) {
+            return kSizeClassesCount;
+        }
+        if constexpr (kMaxElements <= kMaxLookupElements) {
+            static constexpr auto kLookupTable = MakeLookupTable<kSizeClassesCount, kSizeClasses>();
+            return kLookupTable[n];
+        } else {
+            return std::lower_bound(kSizeClasses.begin(), kSizeClasses.end(), n,
+                                    [](const StackSizeClass& size_class, std::size_t elements) {
+                                        return size_class.elements_ < elements;
+                                    }) - kSizeClasses.begin();
         }
-        return result;
     }
 
-    template<typename T, ContainerCapacity TotalN, size_t MaxN>
-    requires details::chunk_stack_based_allocator::IsStorable<T>
-    constexpr size_t StackBasedAllocator<T, TotalN, MaxN>::GetChunkAllocatorsNumber() {
-        return __builtin_ctz(std::bit_ceil(MaxN));
+    // Takes the next chunk of the buffer, returns nullptr if the class reached its budget or the buffer is exhausted
+    template<typename T, std::size_t TotalN, auto SizeClasses>
+    requires details::chunk_stack_based_allocator::IsStorable<T> &&
+             details::chunk_stack_based_allocator::IsSizeClassesSpec<SizeClasses>
+    void* StackBasedMemoryResource<T, TotalN, SizeClasses>::Carve(std::size_t index) noexcept {
+        const std::size_t size = kSizeClasses[index].elements_ * sizeof(T);
+        if (carved_chunks_[index] >= kSizeClasses[index].max_chunks_ || size > kBufferSize - GetCarvedBytes()) {
+            return nullptr;
+        }
+        carved_chunks_[index]++;
+        void* pointer = current_;
+        current_ += size;
+        return pointer;
     }
 
 
-    //ChunkStackBasedAllocator implementation
-    namespace details::chunk_stack_based_allocator {
+    //StackBasedAllocator implementation
+    template<typename T, typename Resource>
+    StackBasedAllocator<T, Resource>::StackBasedAllocator(Resource& resource) noexcept : resource_(&resource) {}
 
-        template<typename T>
-        template<typename Storage>
-        ChunkStackBasedAllocator<T>::ChunkStackBasedAllocator(Storage* storage, ContainerCapacity index,
-                                                              ChunkCapacity chunk_capacity, size_t chunks_count) {
-            ContainerCapacity current_index = index;
-            for (int i = 0; i < chunks_count; i++) {
-                auto pointer = reinterpret_cast<char*>(storage) + current_index;
-                auto ptr = new (pointer) Node();
-                ptr->next_ = list_head_;
-                list_head_ = ptr;
-                current_index += chunk_capacity * sizeof(T);
-            }
-        }
+    template<typename T, typename Resource>
+    template<typename U>
+    StackBasedAllocator<T, Resource>::StackBasedAllocator(const StackBasedAllocator<U, Resource>& other) noexcept
+            : resource_(other.GetResource()) {}
+
+    template<typename T, typename Resource>
+    StackBasedAllocator<T, Resource>::pointer StackBasedAllocator<T, Resource>::allocate(std::size_t n) {
+        return static_cast<pointer>(resource_->Allocate(n * sizeof(T), alignof(T)));
+    }
 
+    template<typename T, typename Resource>
+    void StackBasedAllocator<T, Resource>::deallocate(pointer pointer, std::size_t n) noexcept {
+        resource_->Deallocate(pointer, n * sizeof(T), alignof(T));
+    }
+
+    template<typename T, typename Resource>
+    Resource* StackBasedAllocator<T, Resource>::GetResource() const noexcept {
+        return resource_;
+    }
+
+    template<typename T, typename U, typename Resource>
+    bool operator==(const StackBasedAllocator<T, Resource>& lhs, const StackBasedAllocator<U, Resource>& rhs) {
+        return lhs.GetResource() == rhs.GetResource();
+    }
+
+    template<typename T, typename U, typename Resource>
+    bool operator!=(const StackBasedAllocator<T, Resource>& lhs, const StackBasedAllocator<U, Resource>& rhs) {
+        return !(lhs == rhs);
+    }
+
+
+    //ChunkStackBasedAllocator implementation
+    namespace details::chunk_stack_based_allocator {
 
         template<typename T>
         ChunkStackBasedAllocator<T>::ChunkStackBasedAllocator(ChunkStackBasedAllocator&& other) noexcept {
@@ -197,33 +458,24 @@ namespace fast_containers::allocators {
         }
 
         template<typename T>
-        ChunkStackBasedAllocator<T>::Pointer ChunkStackBasedAllocator<T>::Allocate() {
+        ChunkStackBasedAllocator<T>::Pointer ChunkStackBasedAllocator<T>::Allocate() noexcept {
             Node* ptr = list_head_;
-            list_head_ = list_head_->next_;
+            if (ptr) {
+                list_head_ = ptr->next_;
+            }
             return reinterpret_cast<Pointer>(ptr);
         }
 
         template<typename T>
-        void ChunkStackBasedAllocator<T>::Deallocate(ChunkStackBasedAllocator::Pointer pointer) {
-            Node* node_ptr = reinterpret_cast<Node*>(pointer);
+        void ChunkStackBasedAllocator<T>::Deallocate(ChunkStackBasedAllocator::Pointer pointer) noexcept {
+            Node* node_ptr = new(pointer) Node();
             node_ptr->next_ = list_head_;
             list_head_ = node_ptr;
         }
 
-        template<typename T>
-        ChunkStackBasedAllocator<T>::~ChunkStackBasedAllocator() {
-            //Clear();
-        }
-
+        // Chunks are located in the buffer of the resource, so they are just forgotten
         template<typename T>
         void ChunkStackBasedAllocator<T>::Clear() {
-            auto node_ptr = list_head_;
-            while (node_ptr) {
-                auto tmp_ptr = node_ptr;
-                node_ptr = node_ptr->next_;
-                delete tmp_ptr;
-            }
-
             list_head_ = nullptr;
         }
 
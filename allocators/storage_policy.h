@@ -0,0 +1,183 @@
+#ifndef FAST_CONTAINERS_STORAGE_POLICY_H
+#define FAST_CONTAINERS_STORAGE_POLICY_H
+
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "inline_storage.h"
+#include "huge_page_allocator.h"
+
+namespace fast_containers::allocators {
+
+    namespace details::storage_policy {
+
+        inline constexpr std::size_t kPageSize = 4096;
+
+    }
+
+    struct MappedStorageOptions {
+        HugePagePolicy huge_pages_{};
+        bool use_huge_pages_{true};
+        bool prefault_{true}; // Touch every page in the constructor, so there are no page faults later
+        bool lock_{false};    // mlock the pages, they are never swapped out
+    };
+
+    // Fixed array of N elements of T in the separate mapping, so it does not depend on where the container lives.
+    // Locking degrades gracefully: if mlock fails (e.g. RLIMIT_MEMLOCK) the pages are only prefaulted, see IsLocked().
+    // Throws std::bad_alloc if the mapping failed
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    class MappedStorage {
+    public:
+        MappedStorage();
+
+        MappedStorage(const MappedStorage&) = delete;
+        MappedStorage(MappedStorage&&) = delete;
+        MappedStorage& operator=(const MappedStorage&) = delete;
+        MappedStorage& operator=(MappedStorage&&) = delete;
+
+        T* Data() noexcept;
+        const T* Data() const noexcept;
+
+        T& operator[](std::size_t index) noexcept;
+        const T& operator[](std::size_t index) const noexcept;
+
+        static constexpr std::size_t Size() noexcept;
+
+        [[nodiscard]] HugePageBacking GetBacking() const noexcept;
+        [[nodiscard]] bool IsLocked() const noexcept;
+
+        ~MappedStorage();
+
+    private:
+        static constexpr std::size_t GetMappedSize() noexcept;
+
+        void Prefault() noexcept;
+
+    private:
+        T* data_;
+        HugePageBacking backing_{HugePageBacking::kRegular};
+        bool locked_{false};
+
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "Elements live in the mapped memory without construction");
+    };
+
+
+    // Mapped storage policies of the fixed containers (DHeap, IdObjectPool)
+    template<MappedStorageOptions Options>
+    struct MappedStoragePolicy {
+        template<typename T, std::size_t N>
+        using Storage = MappedStorage<T, N, Options>;
+    };
+
+    // Huge pages with the HugePagePolicy fallbacks, prefaulted
+    template<HugePagePolicy Policy = HugePagePolicy{}>
+    using HugePageStoragePolicy = MappedStoragePolicy<MappedStorageOptions{Policy, true, true, false}>;
+
+    // Regular pages, prefaulted
+    using PrefaultedStoragePolicy = MappedStoragePolicy<MappedStorageOptions{{}, false, true, false}>;
+
+    // Huge pages, prefaulted and locked
+    template<HugePagePolicy Policy = HugePagePolicy{}>
+    using LockedStoragePolicy = MappedStoragePolicy<MappedStorageOptions{Policy, true, true, true}>;
+
+
+    // Implementation
+
+    // MappedStorage
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    MappedStorage<T, N, Options>::MappedStorage() {
+        if constexpr (Options.use_huge_pages_) {
+            auto region = MapHugePages(GetMappedSize(), Options.huge_pages_);
+            data_ = static_cast<T*>(region.pointer_);
+            backing_ = region.backing_;
+        } else {
+            data_ = static_cast<T*>(details::huge_page_allocator::Map(GetMappedSize(), 0));
+            if (!data_) {
+                throw std::bad_alloc();
+            }
+        }
+
+        if constexpr (Options.lock_) {
+            // mlock faults the pages in as well
+            locked_ = mlock(data_, GetMappedSize()) == 0;
+        }
+        if constexpr (Options.prefault_) {
+            if (!locked_) {
+                Prefault();
+            }
+        }
+    }
+
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    T* MappedStorage<T, N, Options>::Data() noexcept {
+        return data_;
+    }
+
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    const T* MappedStorage<T, N, Options>::Data() const noexcept {
+        return data_;
+    }
+
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    T& MappedStorage<T, N, Options>::operator[](std::size_t index) noexcept {
+        return data_[index];
+    }
+
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    const T& MappedStorage<T, N, Options>::operator[](std::size_t index) const noexcept {
+        return data_[index];
+    }
+
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    constexpr std::size_t MappedStorage<T, N, Options>::Size() noexcept {
+        return N;
+    }
+
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    HugePageBacking MappedStorage<T, N, Options>::GetBacking() const noexcept {
+        return backing_;
+    }
+
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    bool MappedStorage<T, N, Options>::IsLocked() const noexcept {
+        return locked_;
+    }
+
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    MappedStorage<T, N, Options>::~MappedStorage() {
+        if constexpr (Options.use_huge_pages_) {
+            UnmapHugePages(data_, GetMappedSize(), Options.huge_pages_);
+        } else {
+            munmap(data_, GetMappedSize());
+        }
+    }
+
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    constexpr std::size_t MappedStorage<T, N, Options>::GetMappedSize() noexcept {
+        using details::storage_policy::kPageSize;
+        return ((sizeof(T) * N + kPageSize - 1u) / kPageSize) * kPageSize;
+    }
+
+    // Writes to every page, MADV_POPULATE_WRITE does it with one syscall on Linux 5.14+
+    template<typename T, std::size_t N, MappedStorageOptions Options>
+    void MappedStorage<T, N, Options>::Prefault() noexcept {
+        using details::storage_policy::kPageSize;
+#ifdef MADV_POPULATE_WRITE
+        if (madvise(data_, GetMappedSize(), MADV_POPULATE_WRITE) == 0) {
+            return;
+        }
+#endif
+        auto bytes = reinterpret_cast<volatile char*>(data_);
+        for (std::size_t offset = 0; offset < GetMappedSize(); offset += kPageSize) {
+            bytes[offset] = 0;
+        }
+    }
+
+} // End of namespace fast_containers::allocators
+
+#endif //FAST_CONTAINERS_STORAGE_POLICY_H
@@ -0,0 +1,393 @@
+#ifndef FAST_CONTAINERS_THREAD_CACHING_ALLOCATOR_H
+#define FAST_CONTAINERS_THREAD_CACHING_ALLOCATOR_H
+
+#include <new>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory_resource>
+
+#include "huge_page_allocator.h"
+#include "huge_page_arena.h"
+#include "allocator_stats.h"
+
+namespace fast_containers::allocators {
+
+    namespace details::thread_caching_allocator {
+
+        using huge_page_arena::GetSizeClass;
+        using huge_page_arena::GetClassSize;
+        using huge_page_arena::GetClassAlignment;
+
+        // Larger allocations go to the upstream
+        inline constexpr std::size_t kMaxCachedSize = 1u << 15u;
+        inline constexpr std::size_t kMaxCachedAlignment = 4096;
+        inline constexpr std::size_t kSizeClassesCount = GetSizeClass(kMaxCachedSize) + 1u;
+
+        inline constexpr std::size_t kMaxBatchSize = 32;
+        inline constexpr std::size_t kBatchBytes = 1u << 15u;
+        inline constexpr std::size_t kSpanSize = huge_page_allocator::kHugePageSize;
+
+        // The upper 16 bits of user space pointers are free on x86-64 and AArch64
+        inline constexpr int kTagShift = 48;
+        inline constexpr uint64_t kPointerMask = (uint64_t(1) << kTagShift) - 1u;
+
+        // Chunks are moved between the thread cache and the central free list by batches of ~32 KiB
+        inline constexpr std::array<std::size_t, kSizeClassesCount> kBatchSizes = []() {
+            std::array<std::size_t, kSizeClassesCount> result{};
+            for (std::size_t i = 0; i < kSizeClassesCount; i++) {
+                result[i] = std::clamp(kBatchBytes / GetClassSize(i), std::size_t(1), kMaxBatchSize);
+            }
+            return result;
+        }();
+
+        struct Node {
+            Node* next_{nullptr};
+        };
+
+        // The first chunk of the batch in the central free list. Chunks of the batch are linked by next_,
+        // the next batch and the count of the chunks are packed into next_batch_
+        struct BatchNode {
+            Node* next_{nullptr};
+            uint64_t next_batch_{0};
+        };
+
+        static_assert(sizeof(BatchNode) <= huge_page_arena::kMinAlignment, "BatchNode must fit into the smallest class");
+
+        inline uint64_t Pack(const void* pointer, uint64_t tag) noexcept {
+            return (tag << kTagShift) | reinterpret_cast<uint64_t>(pointer);
+        }
+
+        template<typename P>
+        P* UnpackPointer(uint64_t value) noexcept {
+            return reinterpret_cast<P*>(value & kPointerMask);
+        }
+
+        inline uint64_t UnpackTag(uint64_t value) noexcept {
+            return value >> kTagShift;
+        }
+
+        // Lock-free stack of batches, the tag in the upper bits of the head prevents ABA.
+        // Chunks are never returned to the OS, so reading next_batch_ of the batch popped by another thread is safe
+        class CentralFreeList {
+        public:
+            void Push(Node* head, std::size_t count) noexcept;
+            Node* Pop(std::size_t& count) noexcept;
+
+        private:
+            std::atomic<uint64_t> head_{0};
+        };
+
+        // Per-thread free lists of every size class
+        struct ThreadCache {
+            std::array<Node*, kSizeClassesCount> lists_{};
+            std::array<uint32_t, kSizeClassesCount> counts_{};
+            [[no_unique_address]] AllocatorStats<kSizeClassesCount> stats_;
+
+            ~ThreadCache();
+        };
+
+    } // End of namespace fast_containers::allocators::details::thread_caching_allocator
+
+
+    // Multi-threaded size-class allocator. Every thread allocates from its own cache, the cache exchanges
+    // whole batches of chunks with the lock-free central free lists. Memory freed by another thread
+    // goes to the cache of that thread and returns to the central lists when the cache overflows.
+    // Spans for the new chunks are mapped with the huge page fallbacks under the mutex (slow path).
+    // Deallocation must be sized
+    class ThreadCachingPool : public std::pmr::memory_resource {
+    private:
+        using Node = details::thread_caching_allocator::Node;
+        using ThreadCache = details::thread_caching_allocator::ThreadCache;
+        using CentralFreeList = details::thread_caching_allocator::CentralFreeList;
+
+    public:
+        using Stats = AllocatorStatsSnapshot<details::thread_caching_allocator::kSizeClassesCount>;
+
+        static ThreadCachingPool& Instance();
+
+        ThreadCachingPool(const ThreadCachingPool&) = delete;
+        ThreadCachingPool(ThreadCachingPool&&) = delete;
+        ThreadCachingPool& operator=(const ThreadCachingPool&) = delete;
+        ThreadCachingPool& operator=(ThreadCachingPool&&) = delete;
+
+        void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+        void Deallocate(void* pointer, std::size_t size, std::size_t alignment = alignof(std::max_align_t)) noexcept;
+
+        // Returns the chunks of the current thread cache to the central free lists
+        void FlushThreadCache() noexcept;
+
+        // Counters of the calling thread, the free list depth is the depth of its cache and the mapped bytes are
+        // shared by all threads. Live bytes wrap if the thread frees memory of the other threads,
+        // the sum over all threads is exact
+        [[nodiscard]] Stats GetThreadStats() const noexcept;
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        ThreadCachingPool() = default;
+        ~ThreadCachingPool() override = default;
+
+        friend struct details::thread_caching_allocator::ThreadCache;
+
+        static ThreadCache& GetThreadCache() noexcept;
+
+        void* Refill(ThreadCache& cache, std::size_t size_class);
+        void Flush(ThreadCache& cache, std::size_t size_class, std::size_t count) noexcept;
+
+        Node* Carve(std::size_t size_class, std::size_t count);
+
+    private:
+        std::array<CentralFreeList, details::thread_caching_allocator::kSizeClassesCount> central_lists_{};
+
+        mutable std::mutex span_mutex_;
+        char* span_current_{nullptr};
+        char* span_end_{nullptr};
+        std::size_t mapped_bytes_{0};
+    };
+
+
+    // Stateless allocator for the standard containers
+    template<typename T>
+    class ThreadCachingAllocator {
+    public:
+        using value_type = T;
+        using pointer = T*;
+
+        ThreadCachingAllocator() = default;
+
+        template<typename U>
+        ThreadCachingAllocator(const ThreadCachingAllocator<U>&) noexcept;
+
+        pointer allocate(std::size_t n);
+        void deallocate(pointer pointer, std::size_t n) noexcept;
+    };
+
+    template<typename T, typename U>
+    bool operator==(const ThreadCachingAllocator<T>&, const ThreadCachingAllocator<U>&);
+
+    template<typename T, typename U>
+    bool operator!=(const ThreadCachingAllocator<T>&, const ThreadCachingAllocator<U>&);
+
+
+    // Implementation
+    namespace details::thread_caching_allocator {
+
+        inline void CentralFreeList::Push(Node* head, std::size_t count) noexcept {
+            auto batch = reinterpret_cast<BatchNode*>(head);
+            uint64_t old_head = head_.load(std::memory_order_relaxed);
+            do {
+                batch->next_batch_ = Pack(UnpackPointer<BatchNode>(old_head), count);
+            } while (!head_.compare_exchange_weak(old_head, Pack(batch, UnpackTag(old_head) + 1u),
+                                                  std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        inline Node* CentralFreeList::Pop(std::size_t& count) noexcept {
+            uint64_t old_head = head_.load(std::memory_order_acquire);
+            BatchNode* batch;
+            uint64_t next_batch;
+            do {
+                batch = UnpackPointer<BatchNode>(old_head);
+                if (!batch) {
+                    return nullptr;
+                }
+                next_batch = batch->next_batch_;
+            } while (!head_.compare_exchange_weak(old_head, Pack(UnpackPointer<BatchNode>(next_batch), UnpackTag(old_head) + 1u),
+                                                  std::memory_order_acquire, std::memory_order_acquire));
+            count = UnpackTag(next_batch);
+            return reinterpret_cast<Node*>(batch);
+        }
+
+        inline ThreadCache::~ThreadCache() {
+            auto& pool = ThreadCachingPool::Instance();
+            for (std::size_t i = 0; i < kSizeClassesCount; i++) {
+                if (counts_[i]) {
+                    pool.Flush(*this, i, counts_[i]);
+                }
+            }
+        }
+
+    } // End of namespace fast_containers::allocators::details::thread_caching_allocator
+
+
+    // ThreadCachingPool
+    inline ThreadCachingPool& ThreadCachingPool::Instance() {
+        // Never destroyed, thread caches can be flushed after the static destructors
+        static auto pool = new ThreadCachingPool();
+        return *pool;
+    }
+
+    inline void* ThreadCachingPool::Allocate(std::size_t size, std::size_t alignment) {
+        using namespace details::thread_caching_allocator;
+        if (size > kMaxCachedSize || alignment > kMaxCachedAlignment) [[unlikely]] {
+            void* pointer = ::operator new(size, std::align_val_t(alignment));
+            if constexpr (kAllocatorStatsEnabled) {
+                GetThreadCache().stats_.OnFallbackAllocate(size);
+            }
+            return pointer;
+        }
+
+        const std::size_t size_class = GetSizeClass(size, alignment);
+        ThreadCache& cache = GetThreadCache();
+        cache.stats_.OnAllocate(size_class, size);
+        Node* head = cache.lists_[size_class];
+        if (head) [[likely]] {
+            cache.lists_[size_class] = head->next_;
+            cache.counts_[size_class]--;
+            return head;
+        }
+        return Refill(cache, size_class);
+    }
+
+    inline void ThreadCachingPool::Deallocate(void* pointer, std::size_t size, std::size_t alignment) noexcept {
+        using namespace details::thread_caching_allocator;
+        if (size > kMaxCachedSize || alignment > kMaxCachedAlignment) [[unlikely]] {
+            ::operator delete(pointer, std::align_val_t(alignment));
+            if constexpr (kAllocatorStatsEnabled) {
+                GetThreadCache().stats_.OnFallbackDeallocate(size);
+            }
+            return;
+        }
+
+        const std::size_t size_class = GetSizeClass(size, alignment);
+        ThreadCache& cache = GetThreadCache();
+        cache.stats_.OnDeallocate(size_class, size);
+        auto node = new(pointer) Node();
+        node->next_ = cache.lists_[size_class];
+        cache.lists_[size_class] = node;
+        if (++cache.counts_[size_class] >= 2 * kBatchSizes[size_class]) [[unlikely]] {
+            Flush(cache, size_class, kBatchSizes[size_class]);
+        }
+    }
+
+    inline void ThreadCachingPool::FlushThreadCache() noexcept {
+        ThreadCache& cache = GetThreadCache();
+        for (std::size_t i = 0; i < details::thread_caching_allocator::kSizeClassesCount; i++) {
+            if (cache.counts_[i]) {
+                Flush(cache, i, cache.counts_[i]);
+            }
+        }
+    }
+
+    inline ThreadCachingPool::Stats ThreadCachingPool::GetThreadStats() const noexcept {
+        const ThreadCache& cache = GetThreadCache();
+        Stats stats = cache.stats_.GetSnapshot();
+        if constexpr (kAllocatorStatsEnabled) {
+            for (std::size_t i = 0; i < stats.size_classes_.size(); i++) {
+                stats.size_classes_[i].size_ = details::thread_caching_allocator::GetClassSize(i);
+                stats.size_classes_[i].free_list_depth_ = cache.counts_[i];
+            }
+            std::lock_guard lock{span_mutex_};
+            stats.mapped_bytes_ = mapped_bytes_;
+        }
+        return stats;
+    }
+
+    inline void* ThreadCachingPool::do_allocate(std::size_t bytes, std::size_t alignment) {
+        return Allocate(bytes, alignment);
+    }
+
+    inline void ThreadCachingPool::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+        Deallocate(p, bytes, alignment);
+    }
+
+    inline bool ThreadCachingPool::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    inline ThreadCachingPool::ThreadCache& ThreadCachingPool::GetThreadCache() noexcept {
+        static thread_local ThreadCache cache{};
+        return cache;
+    }
+
+    // Takes a batch from the central free list or carves a new one
+    inline void* ThreadCachingPool::Refill(ThreadCache& cache, std::size_t size_class) {
+        using namespace details::thread_caching_allocator;
+        std::size_t count = 0;
+        Node* head = central_lists_[size_class].Pop(count);
+        if (!head) {
+            count = kBatchSizes[size_class];
+            head = Carve(size_class, count);
+        }
+        cache.lists_[size_class] = head->next_;
+        cache.counts_[size_class] = count - 1u;
+        return head;
+    }
+
+    // Moves count chunks from the head of the thread cache to the central free list as one batch
+    inline void ThreadCachingPool::Flush(ThreadCache& cache, std::size_t size_class, std::size_t count) noexcept {
+        Node* head = cache.lists_[size_class];
+        Node* tail = head;
+        for (std::size_t i = 1; i < count; i++) {
+            tail = tail->next_;
+        }
+        cache.lists_[size_class] = tail->next_;
+        cache.counts_[size_class] -= count;
+        tail->next_ = nullptr;
+        central_lists_[size_class].Push(head, count);
+    }
+
+    inline ThreadCachingPool::Node* ThreadCachingPool::Carve(std::size_t size_class, std::size_t count) {
+        using namespace details::thread_caching_allocator;
+        const std::size_t size = GetClassSize(size_class);
+        const std::size_t alignment = GetClassAlignment(size_class);
+        const std::size_t bytes = size * count;
+
+        char* begin;
+        {
+            std::lock_guard lock{span_mutex_};
+            begin = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(span_current_) + alignment - 1u) & ~(alignment - 1u));
+            if (!span_current_ || begin + bytes > span_end_) {
+                // The rest of the previous span is lost, it is smaller than the batch
+                auto region = MapHugePages(kSpanSize);
+                begin = static_cast<char*>(region.pointer_);
+                span_end_ = begin + region.size_;
+                mapped_bytes_ += region.size_;
+            }
+            span_current_ = begin + bytes;
+        }
+
+        Node* head = nullptr;
+        for (std::size_t i = count; i > 0; i--) {
+            auto node = new(begin + (i - 1u) * size) Node();
+            node->next_ = head;
+            head = node;
+        }
+        return head;
+    }
+
+
+    // ThreadCachingAllocator
+    template<typename T>
+    template<typename U>
+    ThreadCachingAllocator<T>::ThreadCachingAllocator(const ThreadCachingAllocator<U>&) noexcept {}
+
+    template<typename T>
+    ThreadCachingAllocator<T>::pointer ThreadCachingAllocator<T>::allocate(std::size_t n) {
+        return static_cast<pointer>(ThreadCachingPool::Instance().Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    template<typename T>
+    void ThreadCachingAllocator<T>::deallocate(pointer pointer, std::size_t n) noexcept {
+        ThreadCachingPool::Instance().Deallocate(pointer, n * sizeof(T), alignof(T));
+    }
+
+    template<typename T, typename U>
+    bool operator==(const ThreadCachingAllocator<T>&, const ThreadCachingAllocator<U>&) {
+        return true;
+    }
+
+    template<typename T, typename U>
+    bool operator!=(const ThreadCachingAllocator<T>&, const ThreadCachingAllocator<U>&) {
+        return false;
+    }
+
+} // End of namespace fast_containers::allocators
+
+#endif //FAST_CONTAINERS_THREAD_CACHING_ALLOCATOR_H
@@ -0,0 +1,182 @@
+#include <map>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <memory_resource>
+#include <benchmark/benchmark.h>
+
+#include "stack_allocator.h"
+#include "huge_page_arena.h"
+#include "monotonic_arena.h"
+#include "thread_caching_allocator.h"
+#include "benchmark_utils.h"
+
+namespace {
+
+    using namespace fast_containers::benchmarks;
+    using namespace fast_containers::allocators;
+
+    inline constexpr std::size_t kMaxSize = 1u << 16u;
+    inline constexpr std::size_t kRawSize = 64;
+
+    // Every resource is created once per benchmark, Reset() is called after each iteration
+    struct NewDeleteResource {
+        std::pmr::memory_resource* Get() { return std::pmr::new_delete_resource(); }
+        void Reset() {}
+    };
+
+    struct UnsynchronizedPoolResource {
+        std::pmr::memory_resource* Get() { return &resource_; }
+        void Reset() {}
+
+        std::pmr::unsynchronized_pool_resource resource_;
+    };
+
+    struct StackBasedResource {
+        std::pmr::memory_resource* Get() { return resource_.get(); }
+        void Reset() {}
+
+        // 4 MiB fit every node of the largest map, the upstream is never used
+        std::unique_ptr<StackBasedMemoryResource<uint64_t, 1u << 19u>> resource_ =
+                std::make_unique<StackBasedMemoryResource<uint64_t, 1u << 19u>>();
+    };
+
+    struct HugePageArenaResource {
+        std::pmr::memory_resource* Get() { return &resource_; }
+        void Reset() {}
+
+        HugePageArena resource_;
+    };
+
+    struct MonotonicArenaResource {
+        std::pmr::memory_resource* Get() { return &resource_; }
+        void Reset() { resource_.Reset(); }
+
+        MonotonicArena<> resource_;
+    };
+
+    struct ThreadCachingResource {
+        std::pmr::memory_resource* Get() { return &ThreadCachingPool::Instance(); }
+        void Reset() {}
+    };
+
+
+    // Map: insert size keys and erase them in the same order
+    void BM_StdMap(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            std::map<uint64_t, uint64_t> map;
+            for (auto key : keys) {
+                map.emplace(key, key);
+            }
+            for (auto key : keys) {
+                map.erase(key);
+            }
+            benchmark::DoNotOptimize(map);
+        }
+        counter.Finish(int64_t(2 * size));
+    }
+
+    template<typename Resource>
+    void BM_PmrMap(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        Resource resource;
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            {
+                std::pmr::map<uint64_t, uint64_t> map{resource.Get()};
+                for (auto key : keys) {
+                    map.emplace(key, key);
+                }
+                for (auto key : keys) {
+                    map.erase(key);
+                }
+                benchmark::DoNotOptimize(map);
+            }
+            resource.Reset();
+        }
+        counter.Finish(int64_t(2 * size));
+    }
+
+
+    // Raw 64 bytes blocks: the key selects the slot, a free slot is allocated and an occupied one is freed
+    void BM_StdAllocatorRaw(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        std::vector<std::byte*> slots(size, nullptr);
+        std::allocator<std::byte> allocator;
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (auto key : keys) {
+                auto& slot = slots[key % size];
+                if (slot) {
+                    allocator.deallocate(slot, kRawSize);
+                    slot = nullptr;
+                } else {
+                    slot = allocator.allocate(kRawSize);
+                }
+            }
+            for (auto& slot : slots) {
+                if (slot) {
+                    allocator.deallocate(slot, kRawSize);
+                    slot = nullptr;
+                }
+            }
+        }
+        counter.Finish(int64_t(size));
+    }
+
+    template<typename Resource>
+    void BM_PmrRaw(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        std::vector<void*> slots(size, nullptr);
+        Resource resource;
+        auto memory_resource = resource.Get();
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (auto key : keys) {
+                auto& slot = slots[key % size];
+                if (slot) {
+                    memory_resource->deallocate(slot, kRawSize);
+                    slot = nullptr;
+                } else {
+                    slot = memory_resource->allocate(kRawSize);
+                }
+            }
+            for (auto& slot : slots) {
+                if (slot) {
+                    memory_resource->deallocate(slot, kRawSize);
+                    slot = nullptr;
+                }
+            }
+            resource.Reset();
+        }
+        counter.Finish(int64_t(size));
+    }
+
+}
+
+BENCHMARK(BM_StdMap)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrMap, NewDeleteResource)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrMap, UnsynchronizedPoolResource)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrMap, StackBasedResource)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrMap, HugePageArenaResource)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrMap, MonotonicArenaResource)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrMap, ThreadCachingResource)->Apply(DefaultArguments);
+
+BENCHMARK(BM_StdAllocatorRaw)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrRaw, UnsynchronizedPoolResource)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrRaw, StackBasedResource)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrRaw, HugePageArenaResource)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrRaw, MonotonicArenaResource)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_PmrRaw, ThreadCachingResource)->Apply(DefaultArguments);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,122 @@
+#ifndef FAST_CONTAINERS_BENCHMARK_UTILS_H
+#define FAST_CONTAINERS_BENCHMARK_UTILS_H
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <benchmark/benchmark.h>
+
+#include "perf_counters.h"
+
+namespace fast_containers::benchmarks {
+
+    enum class KeyDistribution {
+        kSequential,
+        kUniform,
+        kZipfian, // s = 0.99, the most popular keys are spread over the key space
+    };
+
+    inline constexpr uint64_t kSeed = 42;
+    inline constexpr double kZipfianExponent = 0.99;
+
+    // Bytes requested from the global operator new, counted by heap_counter.cpp
+    uint64_t GetHeapBytes() noexcept;
+
+    inline const char* ToString(KeyDistribution distribution) {
+        switch (distribution) {
+            case KeyDistribution::kSequential:
+                return "sequential";
+            case KeyDistribution::kUniform:
+                return "uniform";
+            case KeyDistribution::kZipfian:
+                return "zipfian";
+        }
+        return "unknown";
+    }
+
+    // count keys from [0, universe), the seed is fixed, so every run uses the same keys
+    inline std::vector<uint64_t> MakeKeys(KeyDistribution distribution, std::size_t count, std::size_t universe) {
+        std::vector<uint64_t> keys(count);
+        std::mt19937_64 generator{kSeed};
+
+        switch (distribution) {
+            case KeyDistribution::kSequential:
+                for (std::size_t i = 0; i < count; i++) {
+                    keys[i] = i % universe;
+                }
+                break;
+            case KeyDistribution::kUniform: {
+                std::uniform_int_distribution<uint64_t> uniform{0, universe - 1u};
+                for (auto& key : keys) {
+                    key = uniform(generator);
+                }
+                break;
+            }
+            case KeyDistribution::kZipfian: {
+                std::vector<double> cdf(universe);
+                double sum = 0;
+                for (std::size_t rank = 0; rank < universe; rank++) {
+                    sum += 1.0 / std::pow(double(rank + 1u), kZipfianExponent);
+                    cdf[rank] = sum;
+                }
+                std::uniform_real_distribution<double> uniform{0, sum};
+                for (auto& key : keys) {
+                    const std::size_t rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(generator)) - cdf.begin();
+                    // Odd multiplier is a bijection of [0, universe) if universe is a power of two
+                    key = (std::min(rank, universe - 1u) * 0x9E3779B97F4A7C15ull) & (universe - 1u);
+                }
+                break;
+            }
+        }
+        return keys;
+    }
+
+    inline KeyDistribution GetDistribution(const benchmark::State& state) {
+        return static_cast<KeyDistribution>(state.range(1));
+    }
+
+    // Reports items/s, bytes of the global heap per item and the hardware counters per item if perf_event_open
+    // is allowed (see perf_event_paranoid). Counters that are not available are not reported
+    class BenchmarkCounters {
+    public:
+        explicit BenchmarkCounters(benchmark::State& state) : state_(state), start_bytes_(GetHeapBytes()) {
+            perf_counters_.Start();
+        }
+
+        void Finish(int64_t items_per_iteration) {
+            const auto perf = perf_counters_.Stop();
+            const int64_t items = int64_t(state_.iterations()) * items_per_iteration;
+            const double divisor = double(std::max<int64_t>(items, 1));
+            state_.SetItemsProcessed(items);
+            state_.counters["bytes/op"] = double(GetHeapBytes() - start_bytes_) / divisor;
+            for (std::size_t i = 0; i < utils::kPerfEventsCount; i++) {
+                const auto event = static_cast<utils::PerfEvent>(i);
+                if (event != utils::PerfEvent::kCycles && perf.IsAvailable(event)) {
+                    state_.counters[std::string(utils::ToString(event)) + "/op"] = double(perf.Get(event)) / divisor;
+                }
+            }
+            if (perf.GetIpc() > 0.0) {
+                state_.counters["IPC"] = perf.GetIpc();
+            }
+            state_.SetLabel(ToString(GetDistribution(state_)));
+        }
+
+    private:
+        benchmark::State& state_;
+        uint64_t start_bytes_;
+        utils::PerfCounters perf_counters_;
+    };
+
+    // Sizes x distributions
+    inline void DefaultArguments(benchmark::internal::Benchmark* benchmark) {
+        benchmark->ArgNames({"size", "distribution"});
+        benchmark->ArgsProduct({{1u << 8u, 1u << 12u, 1u << 16u}, {0, 1, 2}});
+    }
+
+} // End of namespace fast_containers::benchmarks
+
+#endif //FAST_CONTAINERS_BENCHMARK_UTILS_H
@@ -0,0 +1,562 @@
+#include <any>
+#include <deque>
+#include <list>
+#include <map>
+#include <queue>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <benchmark/benchmark.h>
+
+#include "d_heap.h"
+#include "hierarchical_bitset.h"
+#include "id_object_pool.h"
+#include "inplace_string.h"
+#include "inplace_any.h"
+#include "inplace_function.h"
+#include "spsc_queue.h"
+#include "hash.h"
+#include "timing_wheel.h"
+#include "price_ladder.h"
+#include "inplace_sorted_map.h"
+#include "inplace_vector.h"
+#include "benchmark_utils.h"
+
+namespace {
+
+    using namespace fast_containers::benchmarks;
+
+    inline constexpr std::size_t kMaxSize = 1u << 16u;
+    inline constexpr std::size_t kMaxTimeout = 1u << 16u;
+    inline constexpr std::size_t kMaxTimers = 1u << 18u;
+    inline constexpr std::size_t kPriceLevels = 1024;
+    inline constexpr std::size_t kSortedMapSize = 256;
+    inline constexpr std::size_t kMaxFills = 8;
+
+    struct Order : fast_containers::IdObjectPoolElementBase {
+        Order(uint64_t price, uint64_t quantity) : price_(price), quantity_(quantity) {}
+
+        uint64_t price_;
+        uint64_t quantity_;
+    };
+
+    struct PlainOrder {
+        uint64_t price_;
+        uint64_t quantity_;
+    };
+
+    // Larger than the small buffer of std::any
+    struct Tick {
+        uint64_t sequence_;
+        uint64_t price_;
+        uint64_t quantity_;
+        uint64_t flags_;
+    };
+
+    std::string MakeSymbol(uint64_t key) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "ORDER-%08llu", static_cast<unsigned long long>(key));
+        return buffer;
+    }
+
+
+    // Heaps: insert size keys and pop all of them
+    void BM_MinDHeap(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        auto heap = std::make_unique<fast_containers::MinDHeap<uint64_t, kMaxSize>>();
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (auto key : keys) {
+                heap->Insert(key);
+            }
+            for (std::size_t i = 0; i < size; i++) {
+                benchmark::DoNotOptimize(heap->Top());
+                heap->Pop();
+            }
+        }
+        counter.Finish(int64_t(2 * size));
+    }
+
+    void BM_StdPriorityQueue(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<>> heap;
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (auto key : keys) {
+                heap.push(key);
+            }
+            for (std::size_t i = 0; i < size; i++) {
+                benchmark::DoNotOptimize(heap.top());
+                heap.pop();
+            }
+        }
+        counter.Finish(int64_t(2 * size));
+    }
+
+
+    // Keys are unique in the bitset, the duplicates are merged and popped once
+    void BM_HierarchicalBitset(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        auto set = std::make_unique<fast_containers::HierarchicalBitset<kMaxSize>>();
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (auto key : keys) {
+                set->Insert(key);
+            }
+            while (!set->Empty()) {
+                benchmark::DoNotOptimize(set->PopMin());
+            }
+        }
+        counter.Finish(int64_t(2 * size));
+    }
+
+
+    // Object pools: construct size objects, look them up in the key order and destroy them
+    void BM_IdObjectPool(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, size);
+        auto pool = std::make_unique<fast_containers::IdObjectPool<Order, kMaxSize>>();
+        std::vector<fast_containers::ContainerElementId> ids(size);
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i++) {
+                ids[i] = pool->Construct(i, 1u);
+            }
+            for (auto key : keys) {
+                benchmark::DoNotOptimize(pool->Get(ids[key])->price_);
+            }
+            for (auto id : ids) {
+                pool->Destroy(id);
+            }
+        }
+        counter.Finish(int64_t(3 * size));
+    }
+
+    void BM_StdUnorderedMapPool(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, size);
+        std::unordered_map<uint64_t, PlainOrder> pool;
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i++) {
+                pool.emplace(i, PlainOrder{i, 1u});
+            }
+            for (auto key : keys) {
+                benchmark::DoNotOptimize(pool.find(key)->second.price_);
+            }
+            for (std::size_t i = 0; i < size; i++) {
+                pool.erase(i);
+            }
+        }
+        counter.Finish(int64_t(3 * size));
+    }
+
+
+    // Hash functions: lookups in std::unordered_map with the same layout
+    template<typename Hash>
+    void BM_IntegerHash(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        std::unordered_map<uint64_t, uint64_t, Hash> map;
+        for (std::size_t i = 0; i < kMaxSize; i++) {
+            map.emplace(i, i);
+        }
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (auto key : keys) {
+                benchmark::DoNotOptimize(map.find(key));
+            }
+        }
+        counter.Finish(int64_t(size));
+    }
+
+    // Strings: keys are built from the symbols, lookups are by the prepared keys
+    template<typename String, typename Hash>
+    void BM_StringKey(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, size);
+        std::unordered_map<String, uint64_t, Hash> map;
+        std::vector<String> symbols;
+        for (std::size_t i = 0; i < size; i++) {
+            symbols.emplace_back(MakeSymbol(i));
+            map.emplace(symbols.back(), i);
+        }
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (auto key : keys) {
+                benchmark::DoNotOptimize(map.find(symbols[key]));
+            }
+        }
+        counter.Finish(int64_t(size));
+    }
+
+
+    // Type erased callables: call the functions in the key order
+    template<typename Function>
+    void BM_Function(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, size);
+        std::vector<Function> functions;
+        for (std::size_t i = 0; i < size; i++) {
+            Tick tick{i, i, i, i};
+            functions.emplace_back([tick](uint64_t x) { return tick.price_ + x; });
+        }
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            uint64_t sum = 0;
+            for (auto key : keys) {
+                sum += functions[key](key);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        counter.Finish(int64_t(size));
+    }
+
+
+    // Type erased values: assign and read back a 32 bytes struct
+    void BM_InplaceAny(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        fast_containers::InplaceAny<sizeof(Tick), alignof(Tick)> any;
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (auto key : keys) {
+                any = Tick{key, key, 1u, 0u};
+                benchmark::DoNotOptimize(any.Get<Tick>().price_);
+            }
+        }
+        counter.Finish(int64_t(size));
+    }
+
+    void BM_StdAny(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        std::any any;
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (auto key : keys) {
+                any = Tick{key, key, 1u, 0u};
+                benchmark::DoNotOptimize(std::any_cast<Tick&>(any).price_);
+            }
+        }
+        counter.Finish(int64_t(size));
+    }
+
+
+    // Queues: push and pop batches of 16 messages in one thread
+    void BM_SpscQueue(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        auto queue = std::make_unique<fast_containers::SpscQueue<1024>>();
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i += 16) {
+                for (std::size_t j = i; j < std::min(i + 16, size); j++) {
+                    queue->TryPush(1, Tick{keys[j], keys[j], 1u, 0u});
+                }
+                queue->ConsumeAll([](const auto& message) {
+                    benchmark::DoNotOptimize(message.payload_.template Get<Tick>().price_);
+                });
+            }
+        }
+        counter.Finish(int64_t(2 * size));
+    }
+
+    void BM_StdDeque(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto keys = MakeKeys(GetDistribution(state), size, kMaxSize);
+        std::deque<std::pair<fast_containers::MessageType, Tick>> queue;
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i += 16) {
+                for (std::size_t j = i; j < std::min(i + 16, size); j++) {
+                    queue.emplace_back(1, Tick{keys[j], keys[j], 1u, 0u});
+                }
+                while (!queue.empty()) {
+                    benchmark::DoNotOptimize(queue.front().second.price_);
+                    queue.pop_front();
+                }
+            }
+        }
+        counter.Finish(int64_t(2 * size));
+    }
+
+    // Timers: every tick schedules a timer with the timeout from the distribution and cancels the timer scheduled
+    // size ticks ago with the probability cancel_percent, so about size timers are cancelled before they fire.
+    // The heap cancels lazily: the timer is forgotten and its entry is skipped when it reaches the top
+    void BM_TimingWheel(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto timeouts = MakeKeys(GetDistribution(state), size, kMaxTimeout);
+        const auto cancels = MakeKeys(KeyDistribution::kUniform, size, 128);
+        const auto cancel_percent = uint64_t(state.range(2));
+        auto wheel = std::make_unique<fast_containers::TimingWheel<uint64_t, kMaxTimers>>();
+        std::vector<fast_containers::TimerId> ids(size);
+        uint64_t now = 0;
+        uint64_t fired = 0;
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i++) {
+                if (cancels[i] * 100u < cancel_percent * 128u) {
+                    wheel->Cancel(ids[i]);
+                }
+                ids[i] = wheel->Schedule(now + timeouts[i] + 1u, i);
+                fired += wheel->Advance(now++, [](uint64_t& value) { benchmark::DoNotOptimize(value); });
+            }
+        }
+        benchmark::DoNotOptimize(fired);
+        counter.Finish(int64_t(size));
+    }
+
+    void BM_DHeapTimers(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto timeouts = MakeKeys(GetDistribution(state), size, kMaxTimeout);
+        const auto cancels = MakeKeys(KeyDistribution::kUniform, size, 128);
+        const auto cancel_percent = uint64_t(state.range(2));
+        // Deadline in the high bits and the sequence number in the low bits. A timer lives at most kMaxTimeout
+        // ticks and one timer is scheduled per tick, so the sequence numbers of the live timers are unique
+        constexpr uint64_t kSequenceMask = kMaxTimers - 1u;
+        constexpr std::size_t kDeadlineShift = std::countr_zero(kMaxTimers);
+        auto heap = std::make_unique<fast_containers::MinDHeap<uint64_t, kMaxTimers>>();
+        std::vector<uint8_t> alive(kMaxTimers, 0);
+        std::vector<uint64_t> sequences(size);
+        std::size_t heap_size = 0;
+        uint64_t now = 0;
+        uint64_t fired = 0;
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i++) {
+                if (cancels[i] * 100u < cancel_percent * 128u) {
+                    alive[sequences[i]] = 0;
+                }
+                sequences[i] = now & kSequenceMask;
+                alive[sequences[i]] = 1;
+                heap->Insert(((now + timeouts[i] + 1u) << kDeadlineShift) | sequences[i]);
+                heap_size++;
+                while (heap_size && (heap->Top() >> kDeadlineShift) <= now) {
+                    const uint64_t top = heap->Top();
+                    heap->Pop();
+                    heap_size--;
+                    if (alive[top & kSequenceMask]) {
+                        alive[top & kSequenceMask] = 0;
+                        fired++;
+                    }
+                }
+                now++;
+            }
+        }
+        benchmark::DoNotOptimize(fired);
+        counter.Finish(int64_t(size));
+    }
+
+    // Live timers x timeout distribution x cancel percent
+    void TimerArguments(benchmark::internal::Benchmark* benchmark) {
+        benchmark->ArgNames({"size", "distribution", "cancel_percent"});
+        benchmark->ArgsProduct({{1u << 12u, 1u << 16u}, {0, 1, 2}, {0, 90, 99}});
+    }
+
+    // Order books: add size orders at the prices from the distribution, then cancel them in the same order
+    // reading the best bid after every update
+    void BM_PriceLadder(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto prices = MakeKeys(GetDistribution(state), size, kPriceLevels);
+        auto book = std::make_unique<fast_containers::BidLadder<uint64_t, kPriceLevels, kMaxSize>>();
+        std::vector<fast_containers::OrderId> ids(size);
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i++) {
+                ids[i] = book->Add(int64_t(prices[i]), 1u, i);
+                benchmark::DoNotOptimize(book->GetBestPrice());
+            }
+            for (auto id : ids) {
+                book->Cancel(id);
+                benchmark::DoNotOptimize(book->GetBestPrice());
+            }
+        }
+        counter.Finish(int64_t(2 * size));
+    }
+
+    void BM_StdMapBook(benchmark::State& state) {
+        struct Level {
+            uint64_t quantity_{0};
+            std::list<uint64_t> orders_;
+        };
+        const auto size = std::size_t(state.range(0));
+        const auto prices = MakeKeys(GetDistribution(state), size, kPriceLevels);
+        std::map<int64_t, Level, std::greater<>> book;
+        std::vector<std::list<uint64_t>::iterator> ids(size);
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i++) {
+                auto& level = book[int64_t(prices[i])];
+                level.quantity_++;
+                ids[i] = level.orders_.insert(level.orders_.end(), i);
+                benchmark::DoNotOptimize(book.begin()->first);
+            }
+            for (std::size_t i = 0; i < size; i++) {
+                auto level = book.find(int64_t(prices[i]));
+                level->second.orders_.erase(ids[i]);
+                if (--level->second.quantity_ == 0) {
+                    book.erase(level);
+                }
+                benchmark::DoNotOptimize(book.empty() ? 0 : book.begin()->first);
+            }
+        }
+        counter.Finish(int64_t(2 * size));
+    }
+
+    // Sorted maps: kSortedMapSize levels at every 4th price, look up size prices from the distribution and
+    // replace the level at every 16th price
+    void BM_InplaceSortedMap(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto prices = MakeKeys(GetDistribution(state), size, 4 * kSortedMapSize);
+        auto map = std::make_unique<fast_containers::InplaceSortedMap<int32_t, uint64_t, kSortedMapSize>>();
+        for (std::size_t i = 0; i < kSortedMapSize; i++) {
+            map->InsertSorted(int32_t(4 * i), i);
+        }
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i++) {
+                const auto price = int32_t(prices[i]);
+                benchmark::DoNotOptimize(map->Find(price));
+                if (i % 16u == 0 && map->Erase(price & ~3)) {
+                    map->InsertSorted(price & ~3, i);
+                }
+            }
+        }
+        counter.Finish(int64_t(size));
+    }
+
+    void BM_StdMapSorted(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto prices = MakeKeys(GetDistribution(state), size, 4 * kSortedMapSize);
+        std::map<int32_t, uint64_t> map;
+        for (std::size_t i = 0; i < kSortedMapSize; i++) {
+            map.emplace(int32_t(4 * i), i);
+        }
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i++) {
+                const auto price = int32_t(prices[i]);
+                benchmark::DoNotOptimize(map.find(price));
+                if (i % 16u == 0 && map.erase(price & ~3) == 1) {
+                    map.emplace(price & ~3, i);
+                }
+            }
+        }
+        counter.Finish(int64_t(size));
+    }
+
+    // Per-message vectors: size executions of 1 to kMaxFills fills, every execution builds its own vector
+    template<typename Vector>
+    void BM_InplaceVector(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto fills = MakeKeys(GetDistribution(state), size, kMaxFills);
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i++) {
+                Vector execution;
+                for (uint64_t j = 0; j <= fills[i]; j++) {
+                    execution.PushBack(PlainOrder{i, j});
+                }
+                uint64_t quantity = 0;
+                for (const auto& fill : execution) {
+                    quantity += fill.quantity_;
+                }
+                benchmark::DoNotOptimize(quantity);
+            }
+        }
+        counter.Finish(int64_t(size));
+    }
+
+    void BM_StdVector(benchmark::State& state) {
+        const auto size = std::size_t(state.range(0));
+        const auto fills = MakeKeys(GetDistribution(state), size, kMaxFills);
+
+        BenchmarkCounters counter{state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < size; i++) {
+                std::vector<PlainOrder> execution;
+                for (uint64_t j = 0; j <= fills[i]; j++) {
+                    execution.push_back(PlainOrder{i, j});
+                }
+                uint64_t quantity = 0;
+                for (const auto& fill : execution) {
+                    quantity += fill.quantity_;
+                }
+                benchmark::DoNotOptimize(quantity);
+            }
+        }
+        counter.Finish(int64_t(size));
+    }
+
+    using String = fast_containers::InplaceString<23>;
+    using Function = fast_containers::InplaceFunction<uint64_t(uint64_t), sizeof(Tick)>;
+    using Fills = fast_containers::InplaceVector<PlainOrder, kMaxFills>;
+    using OverflowFills = fast_containers::InplaceVector<PlainOrder, kMaxFills / 2u, std::allocator<PlainOrder>>;
+
+}
+
+BENCHMARK(BM_MinDHeap)->Apply(DefaultArguments);
+BENCHMARK(BM_StdPriorityQueue)->Apply(DefaultArguments);
+BENCHMARK(BM_HierarchicalBitset)->Apply(DefaultArguments);
+
+BENCHMARK(BM_IdObjectPool)->Apply(DefaultArguments);
+BENCHMARK(BM_StdUnorderedMapPool)->Apply(DefaultArguments);
+
+BENCHMARK_TEMPLATE(BM_IntegerHash, fast_containers::utils::Hash<uint64_t>)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_IntegerHash, std::hash<uint64_t>)->Apply(DefaultArguments);
+
+BENCHMARK_TEMPLATE(BM_StringKey, String, std::hash<String>)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_StringKey, std::string, fast_containers::utils::Hash<std::string>)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_StringKey, std::string, std::hash<std::string>)->Apply(DefaultArguments);
+
+BENCHMARK_TEMPLATE(BM_Function, Function)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_Function, std::function<uint64_t(uint64_t)>)->Apply(DefaultArguments);
+
+BENCHMARK(BM_InplaceAny)->Apply(DefaultArguments);
+BENCHMARK(BM_StdAny)->Apply(DefaultArguments);
+
+BENCHMARK(BM_TimingWheel)->Apply(TimerArguments);
+BENCHMARK(BM_DHeapTimers)->Apply(TimerArguments);
+
+BENCHMARK(BM_PriceLadder)->Apply(DefaultArguments);
+BENCHMARK(BM_StdMapBook)->Apply(DefaultArguments);
+
+BENCHMARK(BM_InplaceSortedMap)->Apply(DefaultArguments);
+BENCHMARK(BM_StdMapSorted)->Apply(DefaultArguments);
+
+BENCHMARK_TEMPLATE(BM_InplaceVector, Fills)->Apply(DefaultArguments);
+BENCHMARK_TEMPLATE(BM_InplaceVector, OverflowFills)->Apply(DefaultArguments);
+BENCHMARK(BM_StdVector)->Apply(DefaultArguments);
+
+BENCHMARK(BM_SpscQueue)->Apply(DefaultArguments);
+BENCHMARK(BM_StdDeque)->Apply(DefaultArguments);
+
+BENCHMARK_MAIN();
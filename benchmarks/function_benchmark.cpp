@@ -0,0 +1,90 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#include "inplace_function.h"
+
+namespace {
+
+    inline constexpr std::size_t kIterations = 1u << 24u;
+    inline constexpr std::size_t kCallbacksCount = 64;
+
+    // 32 bytes of captures, std::function stores them on the heap
+    struct Capture {
+        uint64_t a, b, c, d;
+    };
+
+    template<typename T>
+    void DoNotOptimize(T& value) {
+        asm volatile("" : : "r"(&value) : "memory");
+    }
+
+    template<typename Function>
+    void Measure(const char* name) {
+        uint64_t sink = 0;
+
+        // Construction (and destruction) of the callback with the large capture
+        auto start = std::chrono::steady_clock::now(); // Start measure the time
+        for (std::size_t i = 0; i < kIterations; i++) {
+            Capture capture{i, i + 1, i + 2, i + 3};
+            Function function = [capture](uint64_t x) { return x + capture.a + capture.d; };
+            DoNotOptimize(function);
+            sink += function(i);
+        }
+        auto stop = std::chrono::steady_clock::now(); // Stop measure the time
+        auto construct_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+
+        // Invocation of the callbacks with different targets
+        std::vector<Function> callbacks;
+        for (std::size_t i = 0; i < kCallbacksCount; i++) {
+            Capture capture{i, i * 2, i * 3, i * 4};
+            if (i % 2) {
+                callbacks.emplace_back([capture](uint64_t x) { return x ^ capture.b; });
+            } else {
+                callbacks.emplace_back([capture](uint64_t x) { return x + capture.c; });
+            }
+        }
+        start = std::chrono::steady_clock::now(); // Start measure the time
+        for (std::size_t i = 0; i < kIterations; i++) {
+            sink = callbacks[i & (kCallbacksCount - 1)](sink);
+        }
+        stop = std::chrono::steady_clock::now(); // Stop measure the time
+        auto call_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+
+        // Move of the callbacks, e.g. between queues
+        start = std::chrono::steady_clock::now(); // Start measure the time
+        for (std::size_t i = 0; i < kIterations / kCallbacksCount; i++) {
+            std::vector<Function> moved;
+            moved.reserve(kCallbacksCount);
+            for (auto& callback : callbacks) {
+                moved.push_back(std::move(callback));
+            }
+            callbacks.swap(moved);
+        }
+        stop = std::chrono::steady_clock::now(); // Stop measure the time
+        auto move_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+
+        volatile uint64_t result = sink;
+        (void)result;
+
+        std::cout << "Latency of the " << name << " :" << std::endl;
+        std::cout << "construct + call: " << double(construct_ns) / kIterations << " ns" << std::endl;
+        std::cout << "call: " << double(call_ns) / kIterations << " ns" << std::endl;
+        std::cout << "move: " << double(move_ns) / kIterations << " ns" << std::endl << std::endl;
+    }
+
+}
+
+int main() {
+    Measure<std::function<uint64_t(uint64_t)>>("std::function");
+#ifdef __cpp_lib_move_only_function
+    Measure<std::move_only_function<uint64_t(uint64_t)>>("std::move_only_function");
+#else
+    std::cout << "std::move_only_function is not supported by the standard library" << std::endl << std::endl;
+#endif
+    Measure<fast_containers::InplaceFunction<uint64_t(uint64_t), 32>>("fast_containers::InplaceFunction");
+    Measure<fast_containers::InplaceMoveOnlyFunction<uint64_t(uint64_t), 32>>("fast_containers::InplaceMoveOnlyFunction");
+    return 0;
+}
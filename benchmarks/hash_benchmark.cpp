@@ -0,0 +1,219 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <utility>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#include "hash.h"
+#include "inplace_string.h"
+
+namespace {
+
+    using namespace fast_containers;
+
+    using Symbol = InplaceString<32>;
+
+    inline constexpr std::size_t kKeysCount = 1u << 16u;
+    inline constexpr std::size_t kIterations = 1u << 24u;
+    // ~128 expected collisions of the low 32 bits
+    inline constexpr std::size_t kHalvesKeysCount = 1u << 20u;
+
+    struct NamedHash {
+        std::string name;
+        std::function<uint64_t(uint64_t)> hash;
+    };
+
+    std::vector<uint64_t> SequentialKeys() {
+        std::vector<uint64_t> keys(kKeysCount);
+        for (std::size_t i = 0; i < kKeysCount; i++) {
+            keys[i] = i;
+        }
+        return keys;
+    }
+
+    // Typical for pointers and page aligned ids: low bits are always zero
+    std::vector<uint64_t> StridedKeys() {
+        std::vector<uint64_t> keys(kKeysCount);
+        for (std::size_t i = 0; i < kKeysCount; i++) {
+            keys[i] = i << 12u;
+        }
+        return keys;
+    }
+
+    std::vector<uint64_t> RandomKeys() {
+        std::mt19937_64 generator{42};
+        std::vector<uint64_t> keys(kKeysCount);
+        for (auto& key : keys) {
+            key = generator();
+        }
+        return keys;
+    }
+
+    std::vector<Symbol> SymbolKeys() {
+        std::vector<Symbol> keys(kKeysCount);
+        for (std::size_t i = 0; i < kKeysCount; i++) {
+            keys[i] = "SYM" + std::to_string(i) + ".N";
+        }
+        return keys;
+    }
+
+    // Average probe length of the successful search in a linear probing table with the load factor 0.5
+    double LinearProbingLength(const std::vector<uint64_t>& hashes) {
+        const std::size_t mask = 2 * hashes.size() - 1;
+        std::vector<bool> occupied(mask + 1, false);
+        std::size_t probes = 0;
+        for (auto hash : hashes) {
+            std::size_t index = hash & mask;
+            while (occupied[index]) {
+                index = (index + 1) & mask;
+                probes++;
+            }
+            occupied[index] = true;
+            probes++;
+        }
+        return double(probes) / double(hashes.size());
+    }
+
+    // Chi-squared statistic of the low bits bucket distribution divided by the number of buckets. ~1.0 is uniform
+    double ChiSquared(const std::vector<uint64_t>& hashes) {
+        const std::size_t buckets = hashes.size() / 8;
+        std::vector<std::size_t> counts(buckets, 0);
+        for (auto hash : hashes) {
+            counts[hash & (buckets - 1)]++;
+        }
+        const double expected = double(hashes.size()) / double(buckets);
+        double result = 0;
+        for (auto count : counts) {
+            result += (count - expected) * (count - expected) / expected;
+        }
+        return result / double(buckets);
+    }
+
+    // Maximum deviation from 0.5 of the probability that an output bit flips when a single input bit flips
+    double AvalancheBias(const NamedHash& hash, const std::vector<uint64_t>& keys) {
+        std::vector<std::size_t> flips(64 * 64, 0);
+        const std::size_t samples = keys.size() / 16;
+        for (std::size_t k = 0; k < samples; k++) {
+            const uint64_t original = hash.hash(keys[k]);
+            for (int i = 0; i < 64; i++) {
+                const uint64_t changed = original ^ hash.hash(keys[k] ^ (uint64_t(1) << i));
+                for (int j = 0; j < 64; j++) {
+                    flips[i * 64 + j] += (changed >> j) & 1u;
+                }
+            }
+        }
+        double result = 0;
+        for (auto count : flips) {
+            result = std::max(result, std::abs(double(count) / double(samples) - 0.5));
+        }
+        return result;
+    }
+
+    // Share of the keys with equal low halves of the hashes that have equal high halves as well. ~0.0 if the halves
+    // are independent, 1.0 if the high half is a function of the low half, so the high bits add no entropy
+    double HalvesDependence(const NamedHash& hash) {
+        std::mt19937_64 generator{7};
+        std::vector<uint64_t> values(kHalvesKeysCount);
+        for (auto& value : values) {
+            value = hash.hash(generator());
+        }
+        std::sort(values.begin(), values.end(), [](uint64_t lhs, uint64_t rhs) {
+            return std::pair{uint32_t(lhs), lhs} < std::pair{uint32_t(rhs), rhs};
+        });
+        std::size_t low_collisions = 0;
+        std::size_t full_collisions = 0;
+        for (std::size_t i = 1; i < values.size(); i++) {
+            if (uint32_t(values[i]) == uint32_t(values[i - 1])) {
+                low_collisions++;
+                full_collisions += values[i] == values[i - 1];
+            }
+        }
+        return low_collisions ? double(full_collisions) / double(low_collisions) : 0.0;
+    }
+
+    template<typename Key, typename Hash>
+    double Throughput(const std::vector<Key>& keys, Hash hash) {
+        uint64_t sink = 0;
+        auto start = std::chrono::steady_clock::now(); // Start measure the time
+        for (std::size_t i = 0; i < kIterations; i++) {
+            sink += hash(keys[i & (kKeysCount - 1)]);
+        }
+        auto stop = std::chrono::steady_clock::now(); // Stop measure the time
+        volatile uint64_t result = sink;
+        (void)result;
+        return double(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) / kIterations;
+    }
+
+    void PrintQuality(const std::string& keys_name, const std::vector<uint64_t>& keys, const std::vector<NamedHash>& hashes) {
+        std::cout << "Keys: " << keys_name << std::endl;
+        std::cout << std::setw(14) << "hash" << std::setw(14) << "chi2/bucket"
+                  << std::setw(14) << "probe length" << std::setw(14) << "avalanche" << std::endl;
+        for (const auto& hash : hashes) {
+            std::vector<uint64_t> values(keys.size());
+            for (std::size_t i = 0; i < keys.size(); i++) {
+                values[i] = hash.hash(keys[i]);
+            }
+            std::cout << std::setw(14) << hash.name << std::setw(14) << ChiSquared(values)
+                      << std::setw(14) << LinearProbingLength(values)
+                      << std::setw(14) << AvalancheBias(hash, keys) << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+}
+
+int main() {
+    const std::vector<NamedHash> hashes{
+        {"std::hash", [](uint64_t key) { return std::hash<uint64_t>{}(key); }},
+        {"Fmix64", [](uint64_t key) { return utils::Fmix64(key); }},
+        {"MulXorShift", [](uint64_t key) { return utils::MulXorShift(key); }},
+        {"Crc32cHash", [](uint64_t key) { return utils::Crc32cHash(key); }},
+        {"WyHash", [](uint64_t key) { return utils::WyHash(&key, sizeof(key)); }},
+    };
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    // Distribution quality
+    PrintQuality("sequential", SequentialKeys(), hashes);
+    PrintQuality("strided", StridedKeys(), hashes);
+    PrintQuality("random", RandomKeys(), hashes);
+
+    std::cout << "Halves dependence (random keys):" << std::endl;
+    for (const auto& hash : hashes) {
+        std::cout << std::setw(14) << hash.name << std::setw(14) << HalvesDependence(hash) << std::endl;
+    }
+    std::cout << std::endl;
+
+    {
+        auto symbols = SymbolKeys();
+        std::vector<uint64_t> values(symbols.size());
+        for (std::size_t i = 0; i < symbols.size(); i++) {
+            values[i] = symbols[i].Hash();
+        }
+        std::cout << "Keys: symbols" << std::endl;
+        std::cout << "InplaceString::Hash chi2/bucket=" << ChiSquared(values)
+                  << " probe length=" << LinearProbingLength(values) << std::endl << std::endl;
+    }
+
+    // Throughput
+    auto keys = RandomKeys();
+    std::cout << "Throughput (ns/hash):" << std::endl;
+    std::cout << "std::hash   " << Throughput(keys, std::hash<uint64_t>{}) << std::endl;
+    std::cout << "Fmix64      " << Throughput(keys, utils::Fmix64) << std::endl;
+    std::cout << "MulXorShift " << Throughput(keys, utils::MulXorShift) << std::endl;
+    std::cout << "Crc32cHash  " << Throughput(keys, utils::Crc32cHash) << std::endl;
+    std::cout << "WyHash      " << Throughput(keys, [](uint64_t key) { return utils::WyHash(&key, sizeof(key)); }) << std::endl;
+
+    auto symbols = SymbolKeys();
+    std::vector<std::string> strings(symbols.begin(), symbols.end());
+    std::cout << "std::hash<std::string>        " << Throughput(strings, std::hash<std::string>{}) << std::endl;
+    std::cout << "InplaceString<32>::Hash       " << Throughput(symbols, utils::Hash<Symbol>{}) << std::endl;
+    std::cout << "Crc32c(InplaceString<32>)     "
+              << Throughput(symbols, [](const Symbol& key) { return utils::Crc32c(key.Data(), sizeof(Symbol)); }) << std::endl;
+    return 0;
+}
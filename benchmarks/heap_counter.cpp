@@ -0,0 +1,76 @@
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+
+#include "benchmark_utils.h"
+
+// Replaces the global operator new to count the heap bytes of the standard containers.
+// Benchmarks are single threaded, the counter is not atomic
+namespace {
+
+    uint64_t heap_bytes = 0;
+
+    void* Allocate(std::size_t size, std::size_t alignment) {
+        heap_bytes += size;
+        void* pointer = alignment <= alignof(std::max_align_t)
+                        ? std::malloc(size ? size : 1u)
+                        : std::aligned_alloc(alignment, (size + alignment - 1u) / alignment * alignment);
+        if (!pointer) {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+
+}
+
+uint64_t fast_containers::benchmarks::GetHeapBytes() noexcept {
+    return heap_bytes;
+}
+
+void* operator new(std::size_t size) {
+    return Allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+    return Allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
@@ -0,0 +1,211 @@
+#include <memory>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+
+#include "d_heap.h"
+#include "id_object_pool.h"
+#include "inplace_any.h"
+#include "stack_allocator.h"
+#include "huge_page_arena.h"
+#include "monotonic_arena.h"
+#include "thread_caching_allocator.h"
+#include "latency_utils.h"
+
+// Per-operation latency: every operation is timed separately, the table shows the percentiles in nanoseconds.
+// Usage: latency_bench [cpu] [samples]
+namespace {
+
+    using namespace fast_containers::benchmarks;
+    using namespace fast_containers::allocators;
+
+    using Histogram = LatencyHistogram<>;
+
+    inline constexpr std::size_t kSeed = 42;
+    inline constexpr std::size_t kCapacity = 1u << 16u;
+    inline constexpr std::size_t kLiveElements = kCapacity / 2u; // The containers are half full
+    inline constexpr std::size_t kLiveBlocks = 1024;
+    inline constexpr std::size_t kBlockSize = 64;
+
+    struct Settings {
+        TscCalibration calibration_;
+        std::size_t warmup_{100000};
+        std::size_t samples_{1000000};
+    };
+
+    struct Order : fast_containers::IdObjectPoolElementBase {
+        Order(uint64_t price, uint64_t quantity) : price_(price), quantity_(quantity) {}
+
+        uint64_t price_;
+        uint64_t quantity_;
+    };
+
+    struct Tick {
+        uint64_t sequence_;
+        uint64_t price_;
+        uint64_t quantity_;
+        uint64_t flags_;
+    };
+
+    // Times the single call of the function, warmup calls are not recorded
+    template<typename Function>
+    void Measure(Histogram& histogram, bool record, const Settings& settings, Function&& function) {
+        const uint64_t start = ReadTscStart();
+        function();
+        const uint64_t end = ReadTscEnd();
+        if (record) {
+            const uint64_t overhead = settings.calibration_.overhead_ticks_;
+            histogram.Record(end - start > overhead ? end - start - overhead : 0u);
+        }
+    }
+
+
+    // Construct, random Get and Destroy of the random live element
+    void MeasureIdObjectPool(const Settings& settings) {
+        auto pool = std::make_unique<fast_containers::IdObjectPool<Order, kCapacity>>();
+        std::vector<fast_containers::ContainerElementId> ids;
+        std::mt19937_64 generator{kSeed};
+        for (std::size_t i = 0; i < kLiveElements; i++) {
+            ids.push_back(pool->Construct(i, 1u));
+        }
+
+        Histogram construct, get, destroy;
+        for (std::size_t i = 0; i < settings.warmup_ + settings.samples_; i++) {
+            const bool record = i >= settings.warmup_;
+            Measure(construct, record, settings, [&] { ids.push_back(pool->Construct(i, 1u)); });
+
+            const auto id = ids[generator() % ids.size()];
+            Measure(get, record, settings, [&] { KeepValue(pool->Get(id)->price_); });
+
+            const std::size_t index = generator() % ids.size();
+            const auto victim = ids[index];
+            Measure(destroy, record, settings, [&] { pool->Destroy(victim); });
+            ids[index] = ids.back();
+            ids.pop_back();
+        }
+
+        PrintPercentiles("IdObjectPool::Construct", construct, settings.calibration_);
+        PrintPercentiles("IdObjectPool::Get", get, settings.calibration_);
+        PrintPercentiles("IdObjectPool::Destroy", destroy, settings.calibration_);
+    }
+
+    // Insert of the random key and Pop of the minimum
+    void MeasureDHeap(const Settings& settings) {
+        auto heap = std::make_unique<fast_containers::MinDHeap<uint64_t, kCapacity>>();
+        std::mt19937_64 generator{kSeed};
+        for (std::size_t i = 0; i < kLiveElements; i++) {
+            heap->Insert(generator() % kCapacity);
+        }
+
+        Histogram insert, top, pop;
+        for (std::size_t i = 0; i < settings.warmup_ + settings.samples_; i++) {
+            const bool record = i >= settings.warmup_;
+            const uint64_t key = generator() % kCapacity;
+            Measure(insert, record, settings, [&] { heap->Insert(key); });
+            Measure(top, record, settings, [&] { KeepValue(heap->Top()); });
+            Measure(pop, record, settings, [&] { heap->Pop(); });
+        }
+
+        PrintPercentiles("MinDHeap::Insert", insert, settings.calibration_);
+        PrintPercentiles("MinDHeap::Top", top, settings.calibration_);
+        PrintPercentiles("MinDHeap::Pop", pop, settings.calibration_);
+    }
+
+    // Copy of the 32 bytes struct in and out
+    void MeasureInplaceTrivialAny(const Settings& settings) {
+        fast_containers::InplaceTrivialAny<sizeof(Tick), alignof(Tick)> any;
+        std::mt19937_64 generator{kSeed};
+
+        Histogram assign, get;
+        for (std::size_t i = 0; i < settings.warmup_ + settings.samples_; i++) {
+            const bool record = i >= settings.warmup_;
+            const Tick tick{i, generator(), 1u, 0u};
+            Measure(assign, record, settings, [&] { any = tick; KeepValue(any); });
+            Measure(get, record, settings, [&] { KeepValue(any.Get<Tick>().price_); });
+        }
+
+        PrintPercentiles("InplaceTrivialAny::operator=", assign, settings.calibration_);
+        PrintPercentiles("InplaceTrivialAny::Get", get, settings.calibration_);
+    }
+
+    // kBlockSize allocations and deallocations of the random live block, about kLiveBlocks are alive
+    void MeasureResource(const char* allocate_name, const char* deallocate_name,
+                         std::pmr::memory_resource* resource, const Settings& settings) {
+        std::vector<void*> blocks;
+        std::mt19937_64 generator{kSeed};
+
+        Histogram allocate, deallocate;
+        for (std::size_t i = 0; i < settings.warmup_ + settings.samples_; i++) {
+            const bool record = i >= settings.warmup_;
+            if (blocks.size() < kLiveBlocks / 2u || (blocks.size() < 2u * kLiveBlocks && generator() % 2u)) {
+                void* block = nullptr;
+                Measure(allocate, record, settings, [&] { block = resource->allocate(kBlockSize); KeepValue(block); });
+                blocks.push_back(block);
+            } else {
+                const std::size_t index = generator() % blocks.size();
+                void* block = blocks[index];
+                Measure(deallocate, record, settings, [&] { resource->deallocate(block, kBlockSize); });
+                blocks[index] = blocks.back();
+                blocks.pop_back();
+            }
+        }
+        for (auto block : blocks) {
+            resource->deallocate(block, kBlockSize);
+        }
+
+        PrintPercentiles(allocate_name, allocate, settings.calibration_);
+        PrintPercentiles(deallocate_name, deallocate, settings.calibration_);
+    }
+
+    void MeasureAllocators(const Settings& settings) {
+        MeasureResource("new_delete_resource::allocate", "new_delete_resource::deallocate",
+                        std::pmr::new_delete_resource(), settings);
+        {
+            std::pmr::unsynchronized_pool_resource resource;
+            MeasureResource("unsynchronized_pool::allocate", "unsynchronized_pool::deallocate", &resource, settings);
+        }
+        {
+            auto resource = std::make_unique<StackBasedMemoryResource<uint64_t, 1u << 16u>>();
+            MeasureResource("StackBasedMemoryResource::Allocate", "StackBasedMemoryResource::Deallocate",
+                            resource.get(), settings);
+        }
+        {
+            HugePageArena resource;
+            MeasureResource("HugePageArena::Allocate", "HugePageArena::Deallocate", &resource, settings);
+        }
+        {
+            // Deallocation is a no-op, so the overflow blocks are allocated from the upstream while the arena grows
+            MonotonicArena<> resource;
+            MeasureResource("MonotonicArena::Allocate", "MonotonicArena::Deallocate", &resource, settings);
+        }
+        MeasureResource("ThreadCachingPool::Allocate", "ThreadCachingPool::Deallocate",
+                        &ThreadCachingPool::Instance(), settings);
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const int cpu = argc > 1 ? std::atoi(argv[1]) : 0;
+    Settings settings;
+    if (argc > 2) {
+        settings.samples_ = std::strtoull(argv[2], nullptr, 10);
+        settings.warmup_ = settings.samples_ / 10u;
+    }
+
+    // Pin before the calibration, the counter is read on the same core
+    const bool pinned = PinThread(cpu);
+    settings.calibration_ = CalibrateTsc();
+    std::printf("cpu %d (%s), %.3f ticks/ns, timer overhead %llu ticks is subtracted, %zu samples\n\n",
+                cpu, pinned ? "pinned" : "not pinned", 1.0 / settings.calibration_.nanoseconds_per_tick_,
+                static_cast<unsigned long long>(settings.calibration_.overhead_ticks_), settings.samples_);
+
+    PrintPercentilesHeader();
+    MeasureIdObjectPool(settings);
+    MeasureDHeap(settings);
+    MeasureInplaceTrivialAny(settings);
+    MeasureAllocators(settings);
+    return 0;
+}
@@ -0,0 +1,233 @@
+#ifndef FAST_CONTAINERS_LATENCY_UTILS_H
+#define FAST_CONTAINERS_LATENCY_UTILS_H
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace fast_containers::benchmarks {
+
+    // Reads the time stamp counter for the start of the measured code: lfence keeps the earlier instructions
+    // from finishing after rdtsc and the measured ones from starting before it
+    inline uint64_t ReadTscStart() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_lfence();
+        const uint64_t tsc = __rdtsc();
+        _mm_lfence();
+        return tsc;
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    // rdtscp waits for the measured instructions, lfence keeps the later ones from starting before it
+    inline uint64_t ReadTscEnd() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned int aux;
+        const uint64_t tsc = __rdtscp(&aux);
+        _mm_lfence();
+        return tsc;
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    // Keeps the value and the memory writes before it, so the measured code is not optimized away
+    template<typename T>
+    inline void KeepValue(const T& value) noexcept {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // Pins the calling thread to the cpu, returns false if it is not allowed
+    inline bool PinThread(int cpu) noexcept {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+
+    // Ticks to nanoseconds and the cost of the empty measurement
+    struct TscCalibration {
+        double nanoseconds_per_tick_{1.0};
+        uint64_t overhead_ticks_{0};
+    };
+
+    // Compares the counter with steady_clock over the duration, the overhead is the minimum of the empty measurements
+    inline TscCalibration CalibrateTsc(std::chrono::milliseconds duration = std::chrono::milliseconds{200}) {
+        TscCalibration calibration;
+
+        const auto clock_start = std::chrono::steady_clock::now();
+        const uint64_t tsc_start = ReadTscStart();
+        while (std::chrono::steady_clock::now() - clock_start < duration) {
+        }
+        const uint64_t tsc_end = ReadTscEnd();
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - clock_start).count();
+        calibration.nanoseconds_per_tick_ = double(nanoseconds) / double(std::max<uint64_t>(tsc_end - tsc_start, 1u));
+
+        uint64_t overhead = std::numeric_limits<uint64_t>::max();
+        for (int i = 0; i < 100000; i++) {
+            const uint64_t start = ReadTscStart();
+            const uint64_t end = ReadTscEnd();
+            overhead = std::min(overhead, end - start);
+        }
+        calibration.overhead_ticks_ = overhead;
+        return calibration;
+    }
+
+
+    // HdrHistogram-style log-linear histogram: values below 2^SubBucketBits are exact, larger ones are kept
+    // with the relative error below 2^(1 - SubBucketBits). Values above 2^MaxValueBits are saturated
+    template<std::size_t SubBucketBits = 7, std::size_t MaxValueBits = 40>
+    class LatencyHistogram {
+    private:
+        static constexpr std::size_t kSubBucketsCount = std::size_t(1) << SubBucketBits;
+        static constexpr std::size_t kHalfSubBucketsCount = kSubBucketsCount / 2u;
+        static constexpr std::size_t kBucketsCount = (MaxValueBits - SubBucketBits + 2u) * kHalfSubBucketsCount;
+        static constexpr uint64_t kMaxValue = (uint64_t(1) << MaxValueBits) - 1u;
+
+        static_assert(SubBucketBits > 1 && SubBucketBits < MaxValueBits && MaxValueBits < 64);
+
+    public:
+        void Record(uint64_t value) noexcept;
+        void Merge(const LatencyHistogram& other) noexcept;
+        void Reset() noexcept;
+
+        [[nodiscard]] uint64_t GetCount() const noexcept;
+        [[nodiscard]] uint64_t GetMin() const noexcept;
+        [[nodiscard]] uint64_t GetMax() const noexcept;
+        [[nodiscard]] double GetMean() const noexcept;
+
+        // The highest value equivalent to the value at the percentile (0, 100]
+        [[nodiscard]] uint64_t GetValueAtPercentile(double percentile) const noexcept;
+
+    private:
+        static std::size_t GetIndex(uint64_t value) noexcept;
+        static uint64_t GetHighestValue(std::size_t index) noexcept;
+
+    private:
+        std::array<uint64_t, kBucketsCount> counts_{};
+        uint64_t count_{0};
+        uint64_t min_{std::numeric_limits<uint64_t>::max()};
+        uint64_t max_{0};
+        double sum_{0};
+    };
+
+
+    inline void PrintPercentilesHeader() {
+        std::printf("%-36s %10s %9s %9s %9s %9s %9s %9s %9s\n",
+                    "operation (ns)", "count", "min", "p50", "p90", "p99", "p99.9", "p99.99", "max");
+    }
+
+    // Prints a row of the percentile table, the histogram is in ticks
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    void PrintPercentiles(const char* name, const LatencyHistogram<SubBucketBits, MaxValueBits>& histogram,
+                          const TscCalibration& calibration) {
+        const auto ns = [&](uint64_t ticks) { return double(ticks) * calibration.nanoseconds_per_tick_; };
+        std::printf("%-36s %10llu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+                    name, static_cast<unsigned long long>(histogram.GetCount()),
+                    ns(histogram.GetMin()),
+                    ns(histogram.GetValueAtPercentile(50.0)),
+                    ns(histogram.GetValueAtPercentile(90.0)),
+                    ns(histogram.GetValueAtPercentile(99.0)),
+                    ns(histogram.GetValueAtPercentile(99.9)),
+                    ns(histogram.GetValueAtPercentile(99.99)),
+                    ns(histogram.GetMax()));
+    }
+
+
+    // Implementation
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    void LatencyHistogram<SubBucketBits, MaxValueBits>::Record(uint64_t value) noexcept {
+        value = std::min(value, kMaxValue);
+        counts_[GetIndex(value)]++;
+        count_++;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+        sum_ += double(value);
+    }
+
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    void LatencyHistogram<SubBucketBits, MaxValueBits>::Merge(const LatencyHistogram& other) noexcept {
+        for (std::size_t i = 0; i < kBucketsCount; i++) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        sum_ += other.sum_;
+    }
+
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    void LatencyHistogram<SubBucketBits, MaxValueBits>::Reset() noexcept {
+        *this = LatencyHistogram{};
+    }
+
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    uint64_t LatencyHistogram<SubBucketBits, MaxValueBits>::GetCount() const noexcept {
+        return count_;
+    }
+
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    uint64_t LatencyHistogram<SubBucketBits, MaxValueBits>::GetMin() const noexcept {
+        return count_ ? min_ : 0u;
+    }
+
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    uint64_t LatencyHistogram<SubBucketBits, MaxValueBits>::GetMax() const noexcept {
+        return max_;
+    }
+
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    double LatencyHistogram<SubBucketBits, MaxValueBits>::GetMean() const noexcept {
+        return count_ ? sum_ / double(count_) : 0.0;
+    }
+
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    uint64_t LatencyHistogram<SubBucketBits, MaxValueBits>::GetValueAtPercentile(double percentile) const noexcept {
+        if (!count_) {
+            return 0;
+        }
+        const double rank = std::clamp(percentile, 0.0, 100.0) / 100.0 * double(count_);
+        const uint64_t target = std::max<uint64_t>(uint64_t(rank + 0.5), 1u);
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketsCount; i++) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::min(GetHighestValue(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    // The top SubBucketBits bits of the value select the sub bucket, the rest select the bucket.
+    // Buckets after the first one use only the upper half of the sub buckets, the lower half is covered by the previous
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    std::size_t LatencyHistogram<SubBucketBits, MaxValueBits>::GetIndex(uint64_t value) noexcept {
+        const std::size_t width = std::bit_width(value);
+        const std::size_t shift = width > SubBucketBits ? width - SubBucketBits : 0u;
+        return shift * kHalfSubBucketsCount + std::size_t(value >> shift);
+    }
+
+    template<std::size_t SubBucketBits, std::size_t MaxValueBits>
+    uint64_t LatencyHistogram<SubBucketBits, MaxValueBits>::GetHighestValue(std::size_t index) noexcept {
+        const std::size_t shift = index < kSubBucketsCount ? 0u : index / kHalfSubBucketsCount - 1u;
+        const uint64_t sub_bucket = index - shift * kHalfSubBucketsCount;
+        return ((sub_bucket + 1u) << shift) - 1u;
+    }
+
+} // End of namespace fast_containers::benchmarks
+
+#endif //FAST_CONTAINERS_LATENCY_UTILS_H
@@ -0,0 +1,116 @@
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <pthread.h>
+
+#include "spsc_queue.h"
+
+namespace {
+
+    inline constexpr std::size_t kCapacity = 1u << 12u;
+    inline constexpr std::size_t kBatchSize = 16;
+    inline constexpr uint64_t kMessagesCount = 1u << 24u;
+    inline constexpr uint64_t kRoundTripsCount = 1u << 20u;
+
+    inline constexpr fast_containers::MessageType kTick = 1;
+
+    struct Tick {
+        uint64_t sequence;
+        uint64_t price;
+        uint64_t quantity;
+    };
+
+    using Queue = fast_containers::SpscQueue<kCapacity>;
+
+    void PinThread(int core) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(core, &cpu_set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set)) {
+            std::cerr << "Failed to pin the thread to the core " << core << std::endl;
+        }
+    }
+
+    void MeasureThroughput(int producer_core, int consumer_core) {
+        auto queue = std::make_unique<Queue>();
+
+        std::thread producer([&queue, producer_core]() {
+            PinThread(producer_core);
+            Queue::Message batch[kBatchSize];
+            for (uint64_t i = 0; i < kMessagesCount; i += kBatchSize) {
+                for (std::size_t j = 0; j < kBatchSize; j++) {
+                    batch[j].type_ = kTick;
+                    batch[j].payload_ = Tick{i + j, 100, 1};
+                }
+                std::size_t pushed = 0;
+                while (pushed < kBatchSize) {
+                    pushed += queue->TryPushN(batch + pushed, kBatchSize - pushed);
+                }
+            }
+        });
+
+        PinThread(consumer_core);
+        uint64_t received = 0;
+        uint64_t checksum = 0;
+        auto start = std::chrono::steady_clock::now(); // Start measure the time
+        while (received < kMessagesCount) {
+            received += queue->ConsumeAll([&checksum](const Queue::Message& message) {
+                checksum += message.payload_.Get<Tick>().sequence;
+            });
+        }
+        auto stop = std::chrono::steady_clock::now(); // Stop measure the time
+        producer.join();
+
+        if (checksum != kMessagesCount * (kMessagesCount - 1) / 2) {
+            std::cerr << "Wrong checksum" << std::endl;
+        }
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+        std::cout << "Throughput of the SpscQueue (batch " << kBatchSize << "):" << std::endl;
+        std::cout << double(kMessagesCount) * 1000 / double(ns) << " msgs/us, "
+                  << double(ns) / kMessagesCount << " ns/msg" << std::endl;
+    }
+
+    // Ping-pong between two queues, the one way latency is the half of the round trip
+    void MeasureLatency(int producer_core, int consumer_core) {
+        auto ping = std::make_unique<Queue>();
+        auto pong = std::make_unique<Queue>();
+
+        std::thread echo([&ping, &pong, consumer_core]() {
+            PinThread(consumer_core);
+            Queue::Message message;
+            for (uint64_t i = 0; i < kRoundTripsCount; i++) {
+                while (!ping->TryPop(message)) {}
+                while (!pong->TryPushN(&message, 1)) {}
+            }
+        });
+
+        PinThread(producer_core);
+        Queue::Message message;
+        auto start = std::chrono::steady_clock::now(); // Start measure the time
+        for (uint64_t i = 0; i < kRoundTripsCount; i++) {
+            while (!ping->TryPush(kTick, Tick{i, 100, 1})) {}
+            while (!pong->TryPop(message)) {}
+        }
+        auto stop = std::chrono::steady_clock::now(); // Stop measure the time
+        echo.join();
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+        std::cout << "Latency of the SpscQueue:" << std::endl;
+        std::cout << double(ns) / kRoundTripsCount / 2 << " ns/msg (one way)" << std::endl;
+    }
+
+}
+
+// Usage: spsc_bench [producer_core] [consumer_core]
+int main(int argc, char** argv) {
+    const int producer_core = argc > 1 ? std::atoi(argv[1]) : 0;
+    const int consumer_core = argc > 2 ? std::atoi(argv[2]) : 1;
+
+    MeasureThroughput(producer_core, consumer_core);
+    MeasureLatency(producer_core, consumer_core);
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <dlfcn.h>
+
+#include "thread_caching_allocator.h"
+
+namespace {
+
+    inline constexpr std::size_t kObjectSize = 64;
+    inline constexpr std::size_t kLiveObjectsCount = 1024;
+    inline constexpr uint64_t kOperationsCount = 1u << 22u;
+    inline constexpr unsigned kThreadsCounts[] = {1, 2, 4, 8};
+
+    struct Malloc {
+        static constexpr const char* kName = "malloc";
+
+        void* (*malloc_)(std::size_t){&std::malloc};
+        void (*free_)(void*){&std::free};
+
+        void* Allocate(std::size_t size) const {
+            return malloc_(size);
+        }
+
+        void Deallocate(void* pointer, std::size_t) const {
+            free_(pointer);
+        }
+    };
+
+    struct ThreadCaching {
+        static constexpr const char* kName = "ThreadCachingPool";
+
+        fast_containers::allocators::ThreadCachingPool& pool_{fast_containers::allocators::ThreadCachingPool::Instance()};
+
+        void* Allocate(std::size_t size) const {
+            return pool_.Allocate(size);
+        }
+
+        void Deallocate(void* pointer, std::size_t size) const {
+            pool_.Deallocate(pointer, size);
+        }
+    };
+
+    // Every thread keeps a window of live objects and replaces the oldest one on each operation
+    template<typename Allocator>
+    void Run(const Allocator& allocator, uint64_t operations) {
+        std::vector<void*> live(kLiveObjectsCount);
+        for (auto& pointer : live) {
+            pointer = allocator.Allocate(kObjectSize);
+        }
+        for (uint64_t i = 0; i < operations; i++) {
+            void*& pointer = live[i % kLiveObjectsCount];
+            allocator.Deallocate(pointer, kObjectSize);
+            pointer = allocator.Allocate(kObjectSize);
+            *static_cast<volatile char*>(pointer) = char(i);
+        }
+        for (auto pointer : live) {
+            allocator.Deallocate(pointer, kObjectSize);
+        }
+    }
+
+    // Objects are allocated by one thread and freed by another one
+    template<typename Allocator>
+    void RunCrossThread(const Allocator& allocator, uint64_t operations) {
+        std::vector<void*> objects(operations);
+        std::thread producer([&]() {
+            for (auto& pointer : objects) {
+                pointer = allocator.Allocate(kObjectSize);
+            }
+        });
+        producer.join();
+        for (auto pointer : objects) {
+            allocator.Deallocate(pointer, kObjectSize);
+        }
+    }
+
+    template<typename Allocator>
+    void Measure(const std::string& name, const Allocator& allocator) {
+        for (unsigned threads_count : kThreadsCounts) {
+            const uint64_t operations = kOperationsCount / threads_count;
+            std::vector<std::thread> threads;
+
+            auto start = std::chrono::steady_clock::now(); // Start measure the time
+            for (unsigned i = 0; i < threads_count; i++) {
+                threads.emplace_back([&allocator, operations]() {
+                    Run(allocator, operations);
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            auto stop = std::chrono::steady_clock::now(); // Stop measure the time
+
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+            std::cout << name << ", " << threads_count << " threads: "
+                      << double(ns) / kOperationsCount << " ns/op" << std::endl;
+        }
+
+        auto start = std::chrono::steady_clock::now(); // Start measure the time
+        RunCrossThread(allocator, kOperationsCount / 4);
+        auto stop = std::chrono::steady_clock::now(); // Stop measure the time
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+        std::cout << name << ", cross thread: " << double(ns) / (kOperationsCount / 4) << " ns/op" << std::endl;
+    }
+
+}
+
+int main() {
+    Measure(Malloc::kName, Malloc{});
+    Measure(ThreadCaching::kName, ThreadCaching{});
+
+    // jemalloc is measured only if it is installed
+    if (void* library = dlopen("libjemalloc.so.2", RTLD_NOW | RTLD_LOCAL)) {
+        auto jemalloc = Malloc{reinterpret_cast<void* (*)(std::size_t)>(dlsym(library, "malloc")),
+                               reinterpret_cast<void (*)(void*)>(dlsym(library, "free"))};
+        if (jemalloc.malloc_ && jemalloc.free_) {
+            Measure("jemalloc", jemalloc);
+        }
+    } else {
+        std::cout << "jemalloc is not found" << std::endl;
+    }
+    return 0;
+}
@@ -6,9 +6,12 @@
 #include <vector>
 #include <array>
 #include <limits>
+#include <utility>
+#include <algorithm>
 #include <stdexcept>
 
 #include "utils.h"
+#include "inline_storage.h"
 
 namespace fast_containers {
     
@@ -22,59 +25,91 @@ namespace fast_containers {
             ValueType DefaultValue,
             std::size_t Capacity,
             std::size_t D,
-            auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
+            auto Comparator,
+            typename StoragePolicy = allocators::InlineStoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
     class DHeap;
 
-    template<typename ValueType, std::size_t Capacity, std::size_t D = details::d_heap::kDefaultD>
+    template<typename ValueType, std::size_t Capacity, std::size_t D = details::d_heap::kDefaultD,
+            typename StoragePolicy = allocators::InlineStoragePolicy>
     using MinDHeap = DHeap<ValueType,
             std::numeric_limits<ValueType>::max(),
             Capacity, D,
-            [](ValueType parent, ValueType child) -> bool { return (parent < child); }>;
+            [](ValueType parent, ValueType child) -> bool { return (parent < child); },
+            StoragePolicy>;
 
-    template<typename ValueType, std::size_t Capacity, std::size_t D = details::d_heap::kDefaultD>
+    template<typename ValueType, std::size_t Capacity, std::size_t D = details::d_heap::kDefaultD,
+            typename StoragePolicy = allocators::InlineStoragePolicy>
     using MaxDHeap = DHeap<ValueType,
             std::numeric_limits<ValueType>::min(),
             Capacity, D,
-            [](ValueType parent, ValueType child) -> bool { return (parent > child); }>;
+            [](ValueType parent, ValueType child) -> bool { return (parent > child); },
+            StoragePolicy>;
     
     
+    // StoragePolicy chooses where the elements live: inside the heap (inline_storage.h) or in the separate
+    // huge page, prefaulted or locked mapping (see storage_policy.h).
+    // With the InlineStoragePolicy every operation is constexpr, so the heap can be filled at compile time
+    // and a constexpr heap lives in .rodata.
+    // With the MappedFileStoragePolicy or the SharedMemoryStoragePolicy (see mapped_file_storage.h) the elements
+    // and the size live in the file, the changes are wrapped in the seqlock of the storage and the readers
+    // in other processes read the top with TryTop
     template<typename ValueType,
             ValueType DefaultValue,
             std::size_t Capacity,
             std::size_t D,
-            auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
+            auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
     class DHeap {
+    private:
+        static constexpr int GetFirstLeafIndex();
+        static constexpr int GetCapacity();
+
+        using Storage = typename StoragePolicy::template Storage<ValueType, GetCapacity()>;
+
+        static constexpr bool kIsPersistent = allocators::IsPersistentStorage<Storage>;
+
     public:
         using Reference = ValueType&;
 
-        DHeap();
+        constexpr DHeap();
+
+        // Persistent storage only, the arguments are passed to the storage: the path, the schema version and
+        // the access of MappedFileStorage. Creates the file or reattaches to it. If the previous owner crashed,
+        // the heap order is restored in O(Capacity), the operation interrupted by the crash may be lost or applied
+        // twice. The reader attaches to the published file read-only and may call only TryTop
+        template<typename... Args>
+        explicit DHeap(Args&&... args) requires (kIsPersistent && sizeof...(Args) > 0);
 
-        ValueType Top();
+        constexpr ValueType Top() const;
 
-        void Insert(ValueType element);
+        constexpr void Insert(ValueType element);
 
-        void Pop();
-        void Pop(Reference element);
+        constexpr void Pop();
+        constexpr void Pop(Reference element);
+
+        // Persistent storage only, for the readers in other processes: false if the owner is changing the heap
+        [[nodiscard]] bool TryTop(Reference element) const;
 
         ~DHeap() = default;
 
     private:
-        void SiftDown(int index);
-        void SiftUp(int index);
+        constexpr std::size_t& GetLastElementIndex();
+
+        void Rebuild();
 
-        bool IsLeaf(std::size_t index);
+        constexpr void SiftDown(int index);
+        constexpr void SiftUp(int index);
+
+        constexpr bool IsLeaf(std::size_t index) const;
 
         constexpr int GetFirstChildIndex(int index);
         constexpr int GetLastChildIndex(int first_child_index);
 
-        static constexpr int GetFirstLeafIndex();
-        static constexpr int GetCapacity();
-
     private:
-        std::array<ValueType, GetCapacity()> elements{};
-        std::size_t last_element_index{0};
+        Storage elements;
+        std::conditional_t<kIsPersistent, std::size_t*, std::size_t> last_element_index{}; // In the metadata of the persistent storage
 
         static constexpr int kDPow = __builtin_ctz(D);
         static constexpr int kFirstLeafIndex = GetFirstLeafIndex();
@@ -85,43 +120,108 @@ namespace fast_containers {
 
 
     // Implementation
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::DHeap() {
-        elements.fill(DefaultValue);
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::DHeap() {
+        std::fill_n(elements.Data(), GetCapacity(), DefaultValue);
+    }
+
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    template<typename... Args>
+    DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::DHeap(Args&&... args)
+            requires (kIsPersistent && sizeof...(Args) > 0) : elements(std::forward<Args>(args)...) {
+        static_assert(sizeof(std::size_t) <= Storage::kMetadataSize);
+
+        last_element_index = std::launder(reinterpret_cast<std::size_t*>(elements.GetMetadata()));
+        elements.Attach([this] { std::fill_n(elements.Data(), GetCapacity(), DefaultValue); }, [this] { Rebuild(); });
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    ValueType DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::Top() {
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr ValueType DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::Top() const {
         return elements[0];
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    void DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::Insert(ValueType element) {
-        elements[last_element_index] = element;
-        SiftUp(last_element_index++);
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr void DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::Insert(ValueType element) {
+        if constexpr (kIsPersistent) {
+            elements.BeginWrite();
+        }
+        auto& last_index = GetLastElementIndex();
+        elements[last_index] = element;
+        SiftUp(last_index++);
+        if constexpr (kIsPersistent) {
+            elements.EndWrite();
+        }
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    void DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::Pop() {
-        elements[0] = elements[--last_element_index];
-        elements[last_element_index] = DefaultValue;
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr void DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::Pop() {
+        if constexpr (kIsPersistent) {
+            elements.BeginWrite();
+        }
+        auto& last_index = GetLastElementIndex();
+        elements[0] = elements[--last_index];
+        elements[last_index] = DefaultValue;
         SiftDown(0);
+        if constexpr (kIsPersistent) {
+            elements.EndWrite();
+        }
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    void DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::Pop(ValueType& element) {
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr void DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::Pop(ValueType& element) {
         element = elements[0];
         Pop();
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    void DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::SiftDown(int index) {
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    bool DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::TryTop(ValueType& element) const {
+        static_assert(kIsPersistent, "The storage is not persistent");
+        return elements.TryLoad(0, element);
+    }
+
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr std::size_t& DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::GetLastElementIndex() {
+        if constexpr (kIsPersistent) {
+            return *last_element_index;
+        } else {
+            return last_element_index;
+        }
+    }
+
+    // The elements after the size are reset and the heap order is restored from the last parent to the root.
+    // Called by the storage inside its write section
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    void DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::Rebuild() {
+        auto& last_index = GetLastElementIndex();
+        last_index = std::min(last_index, std::size_t(GetCapacity()));
+        std::fill(elements.Data() + last_index, elements.Data() + GetCapacity(), DefaultValue);
+        for (int index = kFirstLeafIndex; index-- > 0;) {
+            SiftDown(index);
+        }
+    }
+
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr void DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::SiftDown(int index) {
         while (!IsLeaf(index)) {
             const int first_child_index = GetFirstChildIndex(index);
             const int last_child_index = GetLastChildIndex(first_child_index);
@@ -142,9 +242,10 @@ namespace fast_containers {
         }
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    void DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::SiftUp(int index) {
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr void DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::SiftUp(int index) {
         while (index) {
             const int parent_index = (index - 1) >> kDPow;
             if (Comparator(elements[index], elements[parent_index])) {
@@ -156,27 +257,31 @@ namespace fast_containers {
         }
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    bool DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::IsLeaf(std::size_t index) {
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr bool DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::IsLeaf(std::size_t index) const {
         return index >= kFirstLeafIndex;
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    constexpr int DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::GetFirstChildIndex(int index) {
-        return (index << DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::kDPow) + 1;
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr int DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::GetFirstChildIndex(int index) {
+        return (index << DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::kDPow) + 1;
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    constexpr int DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::GetLastChildIndex(int first_child_index) {
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr int DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::GetLastChildIndex(int first_child_index) {
         return first_child_index + D;
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    constexpr int DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::GetFirstLeafIndex() {
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr int DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::GetFirstLeafIndex() {
         for (int i = 0; i < Capacity; i++) {
             const int first_child_index = (i << __builtin_ctz(D)) + 1;
             if (first_child_index >= Capacity) {
@@ -186,9 +291,10 @@ namespace fast_containers {
         throw std::out_of_range("First leaf index is not found");
     }
 
-    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator>
-    requires fast_containers::utils::IsPowerOfTwo<D>
-    constexpr int DHeap<ValueType, DefaultValue, Capacity, D, Comparator>::GetCapacity() {
+    template<typename ValueType, ValueType DefaultValue, std::size_t Capacity, std::size_t D, auto Comparator,
+            typename StoragePolicy>
+    requires fast_containers::utils::IsPowerOfTwo<D> && allocators::IsStoragePolicy<StoragePolicy>
+    constexpr int DHeap<ValueType, DefaultValue, Capacity, D, Comparator, StoragePolicy>::GetCapacity() {
         const int first_child_index = ((GetFirstLeafIndex() - 1) << __builtin_ctz(D)) + 1;
         return first_child_index + D;
     }
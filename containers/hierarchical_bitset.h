@@ -0,0 +1,279 @@
+#ifndef FAST_CONTAINERS_HIERARCHICAL_BITSET_H
+#define FAST_CONTAINERS_HIERARCHICAL_BITSET_H
+
+#include <bit>
+#include <array>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace fast_containers {
+
+    namespace details::hierarchical_bitset {
+
+        inline constexpr std::size_t kWordBits = 64;
+
+        inline constexpr std::size_t GetWordsCount(std::size_t bits) noexcept {
+            return (bits + kWordBits - 1u) / kWordBits;
+        }
+
+        // Level 0 has the bits of the keys, a bit of level l + 1 is set if the word of level l is not empty
+        inline constexpr std::size_t GetDepth(std::size_t n) noexcept {
+            std::size_t depth = 1;
+            for (std::size_t words = GetWordsCount(n); words > 1; words = GetWordsCount(words)) {
+                depth++;
+            }
+            return depth;
+        }
+
+        template<std::size_t N>
+        inline constexpr auto GetLevelOffsets() noexcept {
+            std::array<std::size_t, GetDepth(N) + 1u> offsets{};
+            std::size_t words = GetWordsCount(N);
+            for (std::size_t level = 0; level < GetDepth(N); level++) {
+                offsets[level + 1u] = offsets[level] + words;
+                words = GetWordsCount(words);
+            }
+            return offsets;
+        }
+
+    } // End of namespace fast_containers::details::hierarchical_bitset
+
+    // Set of the keys from [0, N) as the 64-ary tree of bitmaps. Insert, Erase, Min, Max, Successor and Predecessor
+    // are O(log64 N): one tzcnt or lzcnt per level, 3 levels cover 2^18 keys and 4 levels cover 2^24 keys.
+    // Not thread safe
+    template<std::size_t N>
+    requires (N > 0)
+    class HierarchicalBitset {
+    private:
+        static constexpr std::size_t kWordBits = details::hierarchical_bitset::kWordBits;
+        static constexpr std::size_t kDepth = details::hierarchical_bitset::GetDepth(N);
+        static constexpr auto kLevelOffsets = details::hierarchical_bitset::GetLevelOffsets<N>();
+
+    public:
+        // Returned by the searches if there is no such key
+        static constexpr std::size_t kNone = N;
+
+        // Returns false if the key is already in the set
+        bool Insert(std::size_t key) noexcept;
+
+        // Returns false if the key is not in the set
+        bool Erase(std::size_t key) noexcept;
+
+        [[nodiscard]] bool Contains(std::size_t key) const noexcept;
+
+        [[nodiscard]] std::size_t Min() const noexcept;
+        [[nodiscard]] std::size_t Max() const noexcept;
+
+        // The smallest key greater than the key and the largest key less than the key
+        [[nodiscard]] std::size_t Successor(std::size_t key) const noexcept;
+        [[nodiscard]] std::size_t Predecessor(std::size_t key) const noexcept;
+
+        // Erases and returns the smallest key, kNone if the set is empty
+        std::size_t PopMin() noexcept;
+
+        // Calls function(key) for every key in the ascending order, walks only the words of level 0
+        template<typename Function>
+        void ForEach(Function&& function) const;
+
+        void Clear() noexcept;
+
+        [[nodiscard]] std::size_t Size() const noexcept;
+        [[nodiscard]] bool Empty() const noexcept;
+
+        static constexpr std::size_t GetCapacity() noexcept;
+
+    private:
+        [[nodiscard]] uint64_t& Word(std::size_t level, std::size_t index) noexcept;
+        [[nodiscard]] uint64_t Word(std::size_t level, std::size_t index) const noexcept;
+
+        // The smallest and the largest key under the bit of the level
+        [[nodiscard]] std::size_t DescendMin(std::size_t level, std::size_t index) const noexcept;
+        [[nodiscard]] std::size_t DescendMax(std::size_t level, std::size_t index) const noexcept;
+
+    private:
+        std::array<uint64_t, kLevelOffsets[kDepth]> words_{};
+        std::size_t size_{0};
+    };
+
+
+    // Implementation
+    template<std::size_t N>
+    requires (N > 0)
+    bool HierarchicalBitset<N>::Insert(std::size_t key) noexcept {
+        if (Contains(key)) {
+            return false;
+        }
+        std::size_t index = key;
+        for (std::size_t level = 0; level < kDepth; level++) {
+            uint64_t& word = Word(level, index / kWordBits);
+            const bool was_empty = !word;
+            word |= uint64_t(1) << (index % kWordBits);
+            if (!was_empty) {
+                break;
+            }
+            index /= kWordBits;
+        }
+        size_++;
+        return true;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    bool HierarchicalBitset<N>::Erase(std::size_t key) noexcept {
+        if (!Contains(key)) {
+            return false;
+        }
+        std::size_t index = key;
+        for (std::size_t level = 0; level < kDepth; level++) {
+            uint64_t& word = Word(level, index / kWordBits);
+            word &= ~(uint64_t(1) << (index % kWordBits));
+            if (word) {
+                break;
+            }
+            index /= kWordBits;
+        }
+        size_--;
+        return true;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    bool HierarchicalBitset<N>::Contains(std::size_t key) const noexcept {
+        return (Word(0, key / kWordBits) >> (key % kWordBits)) & 1u;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    std::size_t HierarchicalBitset<N>::Min() const noexcept {
+        return Word(kDepth - 1u, 0) ? DescendMin(kDepth - 1u, 0) : kNone;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    std::size_t HierarchicalBitset<N>::Max() const noexcept {
+        return Word(kDepth - 1u, 0) ? DescendMax(kDepth - 1u, 0) : kNone;
+    }
+
+    // Goes up until a word has a set bit after the position, then down to the smallest key under it
+    template<std::size_t N>
+    requires (N > 0)
+    std::size_t HierarchicalBitset<N>::Successor(std::size_t key) const noexcept {
+        if (key + 1u >= N) {
+            return kNone;
+        }
+        std::size_t index = key + 1u;
+        for (std::size_t level = 0; level < kDepth; level++) {
+            const std::size_t word = index / kWordBits;
+            if (word >= kLevelOffsets[level + 1u] - kLevelOffsets[level]) {
+                return kNone;
+            }
+            if (const uint64_t bits = Word(level, word) & (~uint64_t(0) << (index % kWordBits))) {
+                const std::size_t found = word * kWordBits + std::countr_zero(bits);
+                return level ? DescendMin(level - 1u, found) : found;
+            }
+            index = word + 1u;
+        }
+        return kNone;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    std::size_t HierarchicalBitset<N>::Predecessor(std::size_t key) const noexcept {
+        if (key == 0) {
+            return kNone;
+        }
+        std::size_t index = std::min(key, N) - 1u;
+        for (std::size_t level = 0; level < kDepth; level++) {
+            const std::size_t word = index / kWordBits;
+            if (const uint64_t bits = Word(level, word) & (~uint64_t(0) >> (kWordBits - 1u - index % kWordBits))) {
+                const std::size_t found = word * kWordBits + kWordBits - 1u - std::countl_zero(bits);
+                return level ? DescendMax(level - 1u, found) : found;
+            }
+            if (word == 0) {
+                return kNone;
+            }
+            index = word - 1u;
+        }
+        return kNone;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    std::size_t HierarchicalBitset<N>::PopMin() noexcept {
+        const std::size_t key = Min();
+        if (key != kNone) {
+            Erase(key);
+        }
+        return key;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    template<typename Function>
+    void HierarchicalBitset<N>::ForEach(Function&& function) const {
+        for (std::size_t word = 0; word < kLevelOffsets[1]; word++) {
+            for (uint64_t bits = Word(0, word); bits; bits &= bits - 1u) {
+                function(word * kWordBits + std::countr_zero(bits));
+            }
+        }
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    void HierarchicalBitset<N>::Clear() noexcept {
+        words_.fill(0);
+        size_ = 0;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    std::size_t HierarchicalBitset<N>::Size() const noexcept {
+        return size_;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    bool HierarchicalBitset<N>::Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    constexpr std::size_t HierarchicalBitset<N>::GetCapacity() noexcept {
+        return N;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    uint64_t& HierarchicalBitset<N>::Word(std::size_t level, std::size_t index) noexcept {
+        return words_[kLevelOffsets[level] + index];
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    uint64_t HierarchicalBitset<N>::Word(std::size_t level, std::size_t index) const noexcept {
+        return words_[kLevelOffsets[level] + index];
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    std::size_t HierarchicalBitset<N>::DescendMin(std::size_t level, std::size_t index) const noexcept {
+        for (std::size_t current = level + 1u; current-- > 0;) {
+            index = index * kWordBits + std::countr_zero(Word(current, index));
+        }
+        return index;
+    }
+
+    template<std::size_t N>
+    requires (N > 0)
+    std::size_t HierarchicalBitset<N>::DescendMax(std::size_t level, std::size_t index) const noexcept {
+        for (std::size_t current = level + 1u; current-- > 0;) {
+            index = index * kWordBits + kWordBits - 1u - std::countl_zero(Word(current, index));
+        }
+        return index;
+    }
+
+} // End of namespace fast_containers
+
+#endif //FAST_CONTAINERS_HIERARCHICAL_BITSET_H
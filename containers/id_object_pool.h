@@ -4,8 +4,14 @@
 #include <new>
 #include <bit>
 #include <limits>
+#include <atomic>
+#include <cstdint>
+#include <utility>
 #include <type_traits>
 
+#include "allocator_stats.h"
+#include "inline_storage.h"
+
 namespace fast_containers {
 
     // First 32 bits - index in IdObjectPool::buffer_
@@ -21,7 +27,13 @@ namespace fast_containers {
         // Do not use this element
         class IdObjectPoolEmptyElementCopy {
             Generation generation_{0};
-            IdObjectPoolEmptyElementCopy* next_{nullptr};
+            std::size_t next_{0};
+        };
+
+        // Offsets of the free elements in IdObjectPool::buffer_, so the pool does not depend on its address
+        struct FreeList {
+            std::size_t head_{0};
+            std::size_t tail_{0};
         };
 
         template<typename T>
@@ -35,8 +47,9 @@ namespace fast_containers {
     } // End of namespace fast_containers::details::id_container
 
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
+    template<typename T, std::size_t N, typename StoragePolicy = allocators::InlineStoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
     class IdObjectPool;
     
     class IdObjectPoolElementBase {
@@ -51,8 +64,9 @@ namespace fast_containers {
         IdObjectPoolElementBase& operator=(IdObjectPoolElementBase&&) = delete;
 
     protected:
-        template<typename T, std::size_t N>
-        requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
+        template<typename T, std::size_t N, typename StoragePolicy>
+        requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+                 allocators::IsStoragePolicy<StoragePolicy>
         friend class fast_containers::IdObjectPool;
 
         details::id_container::Generation generation_{0};
@@ -70,11 +84,12 @@ namespace fast_containers {
             ~IdObjectPoolEmptyElement() = default;
 
         private:
-            template<typename T, std::size_t N>
-            requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
+            template<typename T, std::size_t N, typename StoragePolicy>
+            requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+                     allocators::IsStoragePolicy<StoragePolicy>
             friend class fast_containers::IdObjectPool;
 
-            IdObjectPoolEmptyElement* next_{nullptr};
+            std::size_t next_{0}; // Offset of the next free element
         };
 
         static_assert(sizeof(IdObjectPoolEmptyElementCopy) == sizeof(IdObjectPoolEmptyElement),
@@ -82,21 +97,40 @@ namespace fast_containers {
 
     } // End of namespace fast_containers::details::id_container
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
+    // StoragePolicy chooses where the elements live: inside the pool (inline_storage.h) or in the separate
+    // huge page, prefaulted or locked mapping (see storage_policy.h).
+    // With the MappedFileStoragePolicy the elements and the free list live in the file (see mapped_file_storage.h):
+    // the restarted process reattaches in O(1) and every ContainerElementId stays valid.
+    // With the SharedMemoryStoragePolicy the readers in other processes attach to the same elements: Construct
+    // publishes the element with the release store of its generation, TryRead validates the read like a seqlock
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
     class IdObjectPool {
     private:
         using ElementBase = IdObjectPoolElementBase;
         using EmptyElement = details::id_container::IdObjectPoolEmptyElement;
         using Generation = details::id_container::Generation;
+        using FreeList = details::id_container::FreeList;
+        using Storage = typename StoragePolicy::template Storage<std::aligned_storage_t<sizeof(T), alignof(T)>, N + 1>;
 
         static constexpr std::size_t kGenerationShift = 32u;
+        static constexpr bool kIsPersistent = allocators::IsPersistentStorage<Storage>;
 
     public:
         using Pointer = T*;
+        using Stats = allocators::AllocatorStatsSnapshot<1>;
 
         IdObjectPool();
 
+        // Persistent storage only, the arguments are passed to the storage: the path, the schema version and
+        // the access of MappedFileStorage. Creates the file or reattaches to it. If the previous owner crashed,
+        // the free list is rebuilt from the generations in O(N), the element that was being changed at the crash
+        // is lost. The schema version must be changed with the layout of T.
+        // The reader attaches to the published file read-only and may call only Contains, Get and TryRead
+        template<typename... Args>
+        explicit IdObjectPool(Args&&... args) requires (kIsPersistent && sizeof...(Args) > 0);
+
         IdObjectPool(const IdObjectPool&) = delete;
         IdObjectPool(IdObjectPool&&) = delete;
         IdObjectPool& operator=(const IdObjectPool&) = delete;
@@ -111,12 +145,30 @@ namespace fast_containers {
 
         void Destroy(ContainerElementId id) noexcept;
 
+        // For the readers in other processes: calls function(const T&) if the element is alive and returns false
+        // if it was not alive or was destroyed during the call, the values read by the function are valid only
+        // if it returned true. In-place changes of the alive elements by the owner are not detected
+        template<typename Function>
+        bool TryRead(ContainerElementId id, Function&& function);
+
+        // The only size class is sizeof(T)
+        [[nodiscard]] Stats GetStats() const noexcept;
+
+        // Persistent storage only: writes the elements to the disk, the destructor does it as well
+        void Sync() noexcept;
+
         ~IdObjectPool() = default;
 
     private:
+        void InitializeFreeList();
+        void RebuildFreeList();
+
+        [[nodiscard]] FreeList& GetFreeList() noexcept;
+        [[nodiscard]] EmptyElement* GetEmptyElement(std::size_t index);
+        [[nodiscard]] Generation LoadGeneration(std::size_t index);
+
         [[nodiscard]] char* AddressOf(std::size_t index);
         [[nodiscard]] ElementBase* GetBase(std::size_t index);
-        std::size_t GetIndex(ElementBase* element);
 
         static constexpr ContainerElementId GetId(std::size_t index, Generation generation);
         static constexpr std::size_t GetIndexFromId(ContainerElementId id);
@@ -127,71 +179,87 @@ namespace fast_containers {
         static constexpr ContainerElementId GetGenerationMask();
 
     private:
-        std::aligned_storage_t<sizeof(T) * (N + 1), alignof(T)> buffer_{};
-        EmptyElement* head_{nullptr};
-        EmptyElement* tail_{nullptr};
+        Storage buffer_;
+        std::conditional_t<kIsPersistent, FreeList*, FreeList> free_list_{}; // In the metadata of the persistent storage
+        [[no_unique_address]] allocators::AllocatorStats<1> stats_;
 
         static_assert(sizeof(T) * (N + 1) <= std::numeric_limits<uint32_t>::max(), "Too much memory is allocated");
     };
 
 
     // Implementation
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    IdObjectPool<T, N>::IdObjectPool() {
-        for (int i = 0; i <= sizeof(T) * N; i += sizeof(T)) {
-            auto empty_element = new(AddressOf(i)) EmptyElement();
-            if (i) {
-                tail_->next_ = empty_element;
-                tail_ = empty_element;
-            } else {
-                head_ = tail_ = empty_element;
-            }
-        }
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    IdObjectPool<T, N, StoragePolicy>::IdObjectPool() {
+        InitializeFreeList();
+    }
+
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    template<typename... Args>
+    IdObjectPool<T, N, StoragePolicy>::IdObjectPool(Args&&... args) requires (kIsPersistent && sizeof...(Args) > 0)
+            : buffer_(std::forward<Args>(args)...) {
+        static_assert(sizeof(FreeList) <= Storage::kMetadataSize);
+
+        free_list_ = std::launder(reinterpret_cast<FreeList*>(buffer_.GetMetadata()));
+        buffer_.Attach([this] { InitializeFreeList(); }, [this] { RebuildFreeList(); });
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
     template<typename... Args>
-    ContainerElementId IdObjectPool<T, N>::Construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+    ContainerElementId IdObjectPool<T, N, StoragePolicy>::Construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
         std::size_t index;
         details::id_container::Generation next_generation;
 
         {
-            auto head = head_;
+            auto& free_list = GetFreeList();
+            auto head = GetEmptyElement(free_list.head_);
 
-            index = GetIndex(head);
-            next_generation = head_->generation_ + 1u;
+            index = free_list.head_;
+            next_generation = head->generation_ + 1u;
 
-            head_ = head_->next_;
+            free_list.head_ = head->next_;
             head->~EmptyElement();
         }
 
         auto element = new (AddressOf(index)) T(std::forward<Args>(args)...);
-        element->generation_ = next_generation;
+        if constexpr (kIsPersistent) {
+            // The readers see the element after its generation
+            std::atomic_ref<Generation>(element->generation_).store(next_generation, std::memory_order_release);
+        } else {
+            element->generation_ = next_generation;
+        }
+        stats_.OnFreeListPop(0);
+        stats_.OnAllocate(0, sizeof(T));
         return GetId(index, next_generation);
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    bool IdObjectPool<T, N>::Contains(ContainerElementId id) {
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    bool IdObjectPool<T, N, StoragePolicy>::Contains(ContainerElementId id) {
         if (id & GetAlignmentMask()) {
             return false;
         }
         auto expected_generation = GetGeneration(id);
-        auto real = GetBase(IdObjectPool::GetIndexFromId(id));
-        return (expected_generation & 1u) && (expected_generation == real->generation_);
+        return (expected_generation & 1u) && (expected_generation == LoadGeneration(GetIndexFromId(id)));
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    IdObjectPool<T, N>::Pointer IdObjectPool<T, N>::Get(ContainerElementId id) {
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    IdObjectPool<T, N, StoragePolicy>::Pointer IdObjectPool<T, N, StoragePolicy>::Get(ContainerElementId id) {
         return std::launder(reinterpret_cast<Pointer>(AddressOf(GetIndexFromId(id))));
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    void IdObjectPool<T, N>::Destroy(ContainerElementId id) noexcept {
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    void IdObjectPool<T, N, StoragePolicy>::Destroy(ContainerElementId id) noexcept {
         std::size_t index;
         Generation next_generation;
 
@@ -201,66 +269,175 @@ namespace fast_containers {
             index = GetIndexFromId(id);
             next_generation = element->generation_ + 1u;
 
+            if constexpr (kIsPersistent) {
+                // The readers see the even generation before the element is overwritten
+                std::atomic_ref<Generation>(element->generation_).store(next_generation, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+            }
             element->~T();
         }
 
         auto empty_element = new(AddressOf(index)) EmptyElement();
         empty_element->generation_ = next_generation;
-        tail_->next_ = empty_element;
-        tail_ = empty_element;
+        auto& free_list = GetFreeList();
+        GetEmptyElement(free_list.tail_)->next_ = index;
+        free_list.tail_ = index;
+        stats_.OnDeallocate(0, sizeof(T));
+        stats_.OnFreeListPush(0);
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    char* IdObjectPool<T, N>::AddressOf(std::size_t index) {
-        return reinterpret_cast<char*>(std::addressof(buffer_)) + index;
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    template<typename Function>
+    bool IdObjectPool<T, N, StoragePolicy>::TryRead(ContainerElementId id, Function&& function) {
+        if (!Contains(id)) {
+            return false;
+        }
+        function(static_cast<const T&>(*Get(id)));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return Contains(id);
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    IdObjectPoolElementBase* IdObjectPool<T, N>::GetBase(std::size_t index) {
-        return std::launder(reinterpret_cast<ElementBase*>(AddressOf(index)));
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    IdObjectPool<T, N, StoragePolicy>::Stats IdObjectPool<T, N, StoragePolicy>::GetStats() const noexcept {
+        Stats stats = stats_.GetSnapshot();
+        if constexpr (allocators::kAllocatorStatsEnabled) {
+            stats.size_classes_[0].size_ = sizeof(T);
+        }
+        return stats;
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    std::size_t IdObjectPool<T, N>::GetIndex(ElementBase* element) {
-        return reinterpret_cast<char*>(element) - reinterpret_cast<char*>(std::addressof(buffer_));
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    void IdObjectPool<T, N, StoragePolicy>::Sync() noexcept {
+        static_assert(kIsPersistent, "The storage is not persistent");
+        buffer_.Sync();
+    }
+
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    void IdObjectPool<T, N, StoragePolicy>::InitializeFreeList() {
+        auto& free_list = GetFreeList();
+        for (std::size_t i = 0; i <= sizeof(T) * N; i += sizeof(T)) {
+            new(AddressOf(i)) EmptyElement();
+            if (i) {
+                GetEmptyElement(free_list.tail_)->next_ = i;
+            } else {
+                free_list.head_ = i;
+            }
+            free_list.tail_ = i;
+        }
+        stats_.OnFreeListPush(0, N + 1);
+    }
+
+    // Generations of the alive elements are odd
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    void IdObjectPool<T, N, StoragePolicy>::RebuildFreeList() {
+        auto& free_list = GetFreeList();
+        std::size_t free_count = 0;
+        for (std::size_t i = 0; i <= sizeof(T) * N; i += sizeof(T)) {
+            if (GetBase(i)->generation_ & 1u) {
+                continue;
+            }
+            if (free_count++) {
+                GetEmptyElement(free_list.tail_)->next_ = i;
+            } else {
+                free_list.head_ = i;
+            }
+            free_list.tail_ = i;
+        }
+        stats_.OnFreeListPush(0, free_count);
+    }
+
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    IdObjectPool<T, N, StoragePolicy>::FreeList& IdObjectPool<T, N, StoragePolicy>::GetFreeList() noexcept {
+        if constexpr (kIsPersistent) {
+            return *free_list_;
+        } else {
+            return free_list_;
+        }
+    }
+
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    details::id_container::IdObjectPoolEmptyElement* IdObjectPool<T, N, StoragePolicy>::GetEmptyElement(std::size_t index) {
+        return std::launder(reinterpret_cast<EmptyElement*>(AddressOf(index)));
+    }
+
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    details::id_container::Generation IdObjectPool<T, N, StoragePolicy>::LoadGeneration(std::size_t index) {
+        if constexpr (kIsPersistent) {
+            return std::atomic_ref<Generation>(GetBase(index)->generation_).load(std::memory_order_acquire);
+        } else {
+            return GetBase(index)->generation_;
+        }
+    }
+
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    char* IdObjectPool<T, N, StoragePolicy>::AddressOf(std::size_t index) {
+        return reinterpret_cast<char*>(buffer_.Data()) + index;
+    }
+
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    IdObjectPoolElementBase* IdObjectPool<T, N, StoragePolicy>::GetBase(std::size_t index) {
+        return std::launder(reinterpret_cast<ElementBase*>(AddressOf(index)));
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    constexpr ContainerElementId IdObjectPool<T, N>::GetId(std::size_t index, Generation generation) {
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    constexpr ContainerElementId IdObjectPool<T, N, StoragePolicy>::GetId(std::size_t index, Generation generation) {
         return (generation << kGenerationShift) | index;
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    constexpr std::size_t IdObjectPool<T, N>::GetIndexFromId(ContainerElementId id) {
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    constexpr std::size_t IdObjectPool<T, N, StoragePolicy>::GetIndexFromId(ContainerElementId id) {
         return id & GetIndexMask();
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    constexpr IdObjectPool<T, N>::Generation IdObjectPool<T, N>::GetGeneration(ContainerElementId id) {
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    constexpr IdObjectPool<T, N, StoragePolicy>::Generation IdObjectPool<T, N, StoragePolicy>::GetGeneration(ContainerElementId id) {
         return (id & GetGenerationMask()) >> kGenerationShift;
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    constexpr ContainerElementId IdObjectPool<T, N>::GetAlignmentMask() {
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    constexpr ContainerElementId IdObjectPool<T, N, StoragePolicy>::GetAlignmentMask() {
         return alignof(T) - 1u;
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    constexpr ContainerElementId IdObjectPool<T, N>::GetIndexMask() {
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    constexpr ContainerElementId IdObjectPool<T, N, StoragePolicy>::GetIndexMask() {
         return std::numeric_limits<uint32_t>::max();
     }
 
-    template<typename T, std::size_t N>
-    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T>
-    constexpr ContainerElementId IdObjectPool<T, N>::GetGenerationMask() {
+    template<typename T, std::size_t N, typename StoragePolicy>
+    requires details::id_container::IsStorable<T> && details::id_container::IsIdObjectPoolElement<T> &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    constexpr ContainerElementId IdObjectPool<T, N, StoragePolicy>::GetGenerationMask() {
         return std::numeric_limits<ContainerElementId>::max() ^ GetIndexMask();
     }
 
@@ -1,24 +1,128 @@
 #ifndef FAST_CONTAINERS_INPLACE_ANY_H
 #define FAST_CONTAINERS_INPLACE_ANY_H
 
+#include <bit>
+#include <array>
 #include <utility>
+#include <algorithm>
 #include <type_traits>
+#include <new>
+#include <cstddef>
 #include <cstring>
+#include <cassert>
 
 namespace fast_containers {
 
-    // todo inplace base
+    namespace details::inplace_any {
 
+        using TypeId = const void*;
+
+        template<typename T>
+        struct TypeTag {
+            static constexpr char kTag{};
+        };
+
+        template<typename T>
+        inline constexpr TypeId kTypeId = &TypeTag<T>::kTag;
+
+        // One static table per stored type.
+        // Trivially copyable types have no operations, so InplaceAny copies the whole buffer with std::memcpy
+        struct Operations {
+            void (*copy_)(void* destination, const void* source);
+            void (*move_)(void* destination, void* source);
+            void (*destroy_)(void* pointer);
+            TypeId type_id_;
+        };
+
+        template<typename T>
+        inline constexpr Operations kTrivialOperations{nullptr, nullptr, nullptr, kTypeId<T>};
+
+        // Move-only types (InplaceMoveOnlyFunction) have no copy operation
+        template<typename T>
+        constexpr auto GetCopyOperation() -> void (*)(void*, const void*) {
+            if constexpr (std::is_copy_constructible_v<T>) {
+                return [](void* destination, const void* source) { new(destination) T(*static_cast<const T*>(source)); };
+            } else {
+                return nullptr;
+            }
+        }
+
+        template<typename T>
+        inline constexpr Operations kNonTrivialOperations{
+            GetCopyOperation<T>(),
+            [](void* destination, void* source) { new(destination) T(std::move(*static_cast<T*>(source))); },
+            [](void* pointer) { static_cast<T*>(pointer)->~T(); },
+            kTypeId<T>
+        };
+
+        template<typename T>
+        inline constexpr const Operations* kOperations = std::is_trivially_copyable_v<T> ? &kTrivialOperations<T>
+                                                                                         : &kNonTrivialOperations<T>;
+
+    } // End of namespace fast_containers::details::inplace_any
 
 
     template<std::size_t N, std::size_t Alignment = N>
     class InplaceAny {
+    private:
+        using Operations = details::inplace_any::Operations;
+
+        template<typename T>
+        using NonConstT = std::remove_cv_t<std::remove_reference_t<T>>;
+
+        template<typename T>
+        static constexpr bool IsStorable = !std::is_same_v<NonConstT<T>, InplaceAny> &&
+                                           std::is_copy_constructible_v<NonConstT<T>> &&
+                                           std::is_nothrow_move_constructible_v<NonConstT<T>> &&
+                                           (sizeof(NonConstT<T>) <= N) && (Alignment % alignof(NonConstT<T>) == 0);
+
+    public:
+        InplaceAny() = default;
+
+        InplaceAny(const InplaceAny& other);
+        InplaceAny(InplaceAny&& other) noexcept;
+        InplaceAny& operator=(const InplaceAny& other);
+        InplaceAny& operator=(InplaceAny&& other) noexcept;
+
+        template<typename T, typename = std::enable_if_t<IsStorable<T>>>
+        InplaceAny(T&& other);
+
+        template<typename T, typename = std::enable_if_t<IsStorable<T>>>
+        InplaceAny& operator=(T&& other);
+
+        // Args may refer to the current value
+        template<typename T, typename... Args>
+        T& Emplace(Args&&... args);
+
+        void Reset() noexcept;
+
+        [[nodiscard]] bool HasValue() const noexcept;
+
+        template<typename T>
+        [[nodiscard]] bool Is() const noexcept;
+
+        // The type is checked in debug builds only
+        template<typename T>
+        T& Get();
+
+        template<typename T>
+        const T& Get() const;
+
+        ~InplaceAny();
+
+        static constexpr std::size_t GetCapacity() noexcept;
 
     private:
+        void CopyFrom(const InplaceAny& other);
+        void MoveFrom(InplaceAny& other) noexcept;
+
         std::aligned_storage_t<N, Alignment> buffer_;
+        const Operations* operations_{nullptr};
     };
 
 
+    // Every operation but Get is constexpr: the value can be stored at compile time and read back by GetValue,
+    // so a constexpr InplaceTrivialAny lives in .rodata. In the constant expressions the type must have no padding
     template<std::size_t N, std::size_t Alignment = N>
     class InplaceTrivialAny {
     private:
@@ -29,23 +133,28 @@ namespace fast_containers {
         static constexpr bool IsCopyable = std::is_trivially_copyable_v<NonConstT<T>> && (sizeof(T) <= N);
 
     public:
-        InplaceTrivialAny() = default;
+        constexpr InplaceTrivialAny() noexcept;
 
-        InplaceTrivialAny(const InplaceTrivialAny& other);
-        InplaceTrivialAny& operator=(const InplaceTrivialAny& other);
+        constexpr InplaceTrivialAny(const InplaceTrivialAny& other) noexcept;
+        constexpr InplaceTrivialAny& operator=(const InplaceTrivialAny& other) noexcept;
 
         template<typename T, typename = std::enable_if_t<IsCopyable<T>>>
-        InplaceTrivialAny(T&& other) noexcept;
+        constexpr InplaceTrivialAny(T&& other) noexcept;
 
         template<typename T, typename = std::enable_if_t<IsCopyable<T>>>
-        InplaceTrivialAny& operator=(T&& other) noexcept;
+        constexpr InplaceTrivialAny& operator=(T&& other) noexcept;
 
+        // The reference into the buffer, runtime only
         template<typename T>
         T& Get();
 
         template<typename T>
         const T& Get() const;
 
+        // The copy of the value, usable in the constant expressions
+        template<typename T>
+        [[nodiscard]] constexpr T GetValue() const noexcept;
+
         // todo destroy
         ~InplaceTrivialAny() = default;
 
@@ -53,37 +162,171 @@ namespace fast_containers {
 
     private:
         template<typename T>
-        void Copy(T&& other);
+        constexpr void Copy(T&& other) noexcept;
 
-        std::aligned_storage_t<N, Alignment> buffer_;
+        alignas(Alignment) std::array<std::byte, N> buffer_;
     };
 
 
     // Implementation
 
+    // InplaceAny
+    template<std::size_t N, std::size_t Alignment>
+    InplaceAny<N, Alignment>::InplaceAny(const InplaceAny& other) {
+        CopyFrom(other);
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    InplaceAny<N, Alignment>::InplaceAny(InplaceAny&& other) noexcept {
+        MoveFrom(other);
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    InplaceAny<N, Alignment>& InplaceAny<N, Alignment>::operator=(const InplaceAny& other) {
+        if (this != &other) {
+            Reset();
+            CopyFrom(other);
+        }
+        return *this;
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    InplaceAny<N, Alignment>& InplaceAny<N, Alignment>::operator=(InplaceAny&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    template<typename T, typename>
+    InplaceAny<N, Alignment>::InplaceAny(T&& other) {
+        Emplace<NonConstT<T>>(std::forward<T>(other));
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    template<typename T, typename>
+    InplaceAny<N, Alignment>& InplaceAny<N, Alignment>::operator=(T&& other) {
+        Emplace<NonConstT<T>>(std::forward<T>(other));
+        return *this;
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    template<typename T, typename... Args>
+    T& InplaceAny<N, Alignment>::Emplace(Args&&... args) {
+        static_assert(IsStorable<T>, "Type is too big, overaligned or not copyable");
+        // The arguments may refer to the current value, e.g. a = a.Get<T>(), so it is destroyed after the new one
+        // is constructed. The value is kept if the constructor throws
+        T value(std::forward<Args>(args)...);
+        Reset();
+        auto pointer = new(&buffer_) T(std::move(value));
+        operations_ = details::inplace_any::kOperations<T>;
+        return *pointer;
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    void InplaceAny<N, Alignment>::Reset() noexcept {
+        if (operations_ && operations_->destroy_) {
+            operations_->destroy_(&buffer_);
+        }
+        operations_ = nullptr;
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    bool InplaceAny<N, Alignment>::HasValue() const noexcept {
+        return operations_ != nullptr;
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    template<typename T>
+    bool InplaceAny<N, Alignment>::Is() const noexcept {
+        return operations_ && operations_->type_id_ == details::inplace_any::kTypeId<T>;
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    template<typename T>
+    T& InplaceAny<N, Alignment>::Get() {
+        assert(Is<T>() && "InplaceAny holds another type");
+        return *std::launder(reinterpret_cast<T*>(&buffer_));
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    template<typename T>
+    const T& InplaceAny<N, Alignment>::Get() const {
+        assert(Is<T>() && "InplaceAny holds another type");
+        return *std::launder(reinterpret_cast<const T*>(&buffer_));
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    InplaceAny<N, Alignment>::~InplaceAny() {
+        Reset();
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    constexpr std::size_t InplaceAny<N, Alignment>::GetCapacity() noexcept {
+        return N;
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    void InplaceAny<N, Alignment>::CopyFrom(const InplaceAny& other) {
+        if (!other.operations_) {
+            return;
+        }
+        if (other.operations_->copy_) {
+            other.operations_->copy_(&buffer_, &other.buffer_);
+        } else {
+            std::memcpy(&buffer_, &other.buffer_, N);
+        }
+        operations_ = other.operations_;
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    void InplaceAny<N, Alignment>::MoveFrom(InplaceAny& other) noexcept {
+        if (!other.operations_) {
+            return;
+        }
+        if (other.operations_->move_) {
+            other.operations_->move_(&buffer_, &other.buffer_);
+        } else {
+            std::memcpy(&buffer_, &other.buffer_, N);
+        }
+        operations_ = other.operations_;
+        other.Reset();
+    }
+
     // InplaceTrivialAny
     template<std::size_t N, std::size_t Alignment>
-    InplaceTrivialAny<N, Alignment>::InplaceTrivialAny(const InplaceTrivialAny& other) {
-        Copy(other.buffer_);
+    constexpr InplaceTrivialAny<N, Alignment>::InplaceTrivialAny() noexcept {
+        // Left uninitialized at runtime, the constant expressions require every byte to be initialized
+        if (std::is_constant_evaluated()) {
+            buffer_.fill(std::byte{0});
+        }
     }
 
     template<std::size_t N, std::size_t Alignment>
-    InplaceTrivialAny<N, Alignment> &InplaceTrivialAny<N, Alignment>::operator=(const InplaceTrivialAny& other) {
+    constexpr InplaceTrivialAny<N, Alignment>::InplaceTrivialAny(const InplaceTrivialAny& other) noexcept
+            : buffer_(other.buffer_) {
+    }
+
+    template<std::size_t N, std::size_t Alignment>
+    constexpr InplaceTrivialAny<N, Alignment>&
+    InplaceTrivialAny<N, Alignment>::operator=(const InplaceTrivialAny& other) noexcept {
         if (this != &other) {
-            Copy(other.buffer_);
+            buffer_ = other.buffer_;
         }
         return *this;
     }
 
     template<std::size_t N, std::size_t Alignment>
     template<typename T, typename>
-    InplaceTrivialAny<N, Alignment>::InplaceTrivialAny(T&& other) noexcept {
+    constexpr InplaceTrivialAny<N, Alignment>::InplaceTrivialAny(T&& other) noexcept : InplaceTrivialAny() {
         Copy(std::forward<T>(other));
     }
 
     template<std::size_t N, std::size_t Alignment>
     template<typename T, typename>
-    InplaceTrivialAny<N, Alignment>& InplaceTrivialAny<N, Alignment>::operator=(T&& other) noexcept {
+    constexpr InplaceTrivialAny<N, Alignment>& InplaceTrivialAny<N, Alignment>::operator=(T&& other) noexcept {
         Copy(std::forward<T>(other));
         return *this;
     }
@@ -91,19 +334,37 @@ namespace fast_containers {
     template<std::size_t N, std::size_t Alignment>
     template<typename T>
     T& InplaceTrivialAny<N, Alignment>::Get() {
-        return *reinterpret_cast<T*>(&buffer_);
+        return *reinterpret_cast<T*>(buffer_.data());
     }
 
     template<std::size_t N, std::size_t Alignment>
     template<typename T>
     const T& InplaceTrivialAny<N, Alignment>::Get() const {
-        return *reinterpret_cast<const T*>(&buffer_);
+        return *reinterpret_cast<const T*>(buffer_.data());
     }
 
     template<std::size_t N, std::size_t Alignment>
     template<typename T>
-    void InplaceTrivialAny<N, Alignment>::Copy(T&& other) {
-        std::memcpy(reinterpret_cast<char*>(&buffer_), reinterpret_cast<const char*>(&other), sizeof(T));
+    constexpr T InplaceTrivialAny<N, Alignment>::GetValue() const noexcept {
+        static_assert(IsCopyable<T>, "Type is too big or not trivially copyable");
+        if (std::is_constant_evaluated()) {
+            std::array<std::byte, sizeof(T)> bytes{};
+            std::copy_n(buffer_.begin(), sizeof(T), bytes.begin());
+            return std::bit_cast<T>(bytes);
+        }
+        return Get<T>();
+    }
+
+    // reinterpret_cast and std::memcpy are not allowed in the constant expressions, std::bit_cast is
+    template<std::size_t N, std::size_t Alignment>
+    template<typename T>
+    constexpr void InplaceTrivialAny<N, Alignment>::Copy(T&& other) noexcept {
+        if (std::is_constant_evaluated()) {
+            const auto bytes = std::bit_cast<std::array<std::byte, sizeof(T)>>(other);
+            std::copy(bytes.begin(), bytes.end(), buffer_.begin());
+        } else {
+            std::memcpy(buffer_.data(), &other, sizeof(T));
+        }
     }
 
     template<std::size_t N, std::size_t Alignment>
@@ -0,0 +1,240 @@
+#ifndef FAST_CONTAINERS_INPLACE_FUNCTION_H
+#define FAST_CONTAINERS_INPLACE_FUNCTION_H
+
+#include <new>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include "inplace_any.h"
+
+namespace fast_containers {
+
+    namespace details::inplace_function {
+
+        inline constexpr std::size_t kDefaultCapacity = 32;
+        inline constexpr std::size_t kDefaultAlignment = alignof(std::max_align_t);
+
+        template<typename R, typename... Args>
+        using Invoker = R (*)(void* callable, Args&&... args);
+
+        // The result of the callable is discarded for R = void, as std::function does
+        template<typename T, typename R, typename... Args>
+        R Invoke(void* callable, Args&&... args) {
+            if constexpr (std::is_void_v<R>) {
+                std::invoke(*static_cast<T*>(callable), std::forward<Args>(args)...);
+            } else {
+                return std::invoke(*static_cast<T*>(callable), std::forward<Args>(args)...);
+            }
+        }
+
+        // Invoker of the empty function, so operator() does not need to check it
+        template<typename R, typename... Args>
+        R InvokeEmpty(void*, Args&&...) {
+            throw std::bad_function_call();
+        }
+
+    } // End of namespace fast_containers::details::inplace_function
+
+
+    template<typename Signature,
+            std::size_t N = details::inplace_function::kDefaultCapacity,
+            std::size_t Alignment = details::inplace_function::kDefaultAlignment,
+            bool Copyable = true>
+    class BasicInplaceFunction;
+
+    template<typename Signature,
+            std::size_t N = details::inplace_function::kDefaultCapacity,
+            std::size_t Alignment = details::inplace_function::kDefaultAlignment>
+    using InplaceFunction = BasicInplaceFunction<Signature, N, Alignment, true>;
+
+    template<typename Signature,
+            std::size_t N = details::inplace_function::kDefaultCapacity,
+            std::size_t Alignment = details::inplace_function::kDefaultAlignment>
+    using InplaceMoveOnlyFunction = BasicInplaceFunction<Signature, N, Alignment, false>;
+
+
+    // Stores the callable in the InplaceAny-like buffer.
+    // The invoker is stored in the object itself, so a call is a single indirect call.
+    // Copy, move and destroy use the static operations table of InplaceAny
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    class BasicInplaceFunction<R(Args...), N, Alignment, Copyable> {
+    private:
+        using Operations = details::inplace_any::Operations;
+        using Invoker = details::inplace_function::Invoker<R, Args...>;
+
+        // Function names decay to the function pointers, as in std::function
+        template<typename F>
+        using DecayF = std::decay_t<F>;
+
+        // Too big and overaligned callables are rejected here, so std::is_constructible tells the truth
+        template<typename F>
+        static constexpr bool IsCallable = !std::is_same_v<DecayF<F>, BasicInplaceFunction> &&
+                                           std::is_constructible_v<DecayF<F>, F> &&
+                                           std::is_invocable_r_v<R, DecayF<F>&, Args...> &&
+                                           (!Copyable || std::is_copy_constructible_v<DecayF<F>>) &&
+                                           std::is_nothrow_move_constructible_v<DecayF<F>> &&
+                                           (sizeof(DecayF<F>) <= N) && (Alignment % alignof(DecayF<F>) == 0);
+
+    public:
+        BasicInplaceFunction() noexcept = default;
+        BasicInplaceFunction(std::nullptr_t) noexcept;
+
+        BasicInplaceFunction(const BasicInplaceFunction& other) requires Copyable;
+        BasicInplaceFunction(BasicInplaceFunction&& other) noexcept;
+        BasicInplaceFunction& operator=(const BasicInplaceFunction& other) requires Copyable;
+        BasicInplaceFunction& operator=(BasicInplaceFunction&& other) noexcept;
+
+        template<typename F, typename = std::enable_if_t<IsCallable<F>>>
+        BasicInplaceFunction(F&& callable);
+
+        template<typename F, typename = std::enable_if_t<IsCallable<F>>>
+        BasicInplaceFunction& operator=(F&& callable);
+
+        R operator()(Args... args) const;
+
+        void Reset() noexcept;
+
+        explicit operator bool() const noexcept;
+
+        ~BasicInplaceFunction();
+
+        static constexpr std::size_t GetCapacity() noexcept;
+
+    private:
+        template<typename F>
+        void Construct(F&& callable);
+
+        void CopyFrom(const BasicInplaceFunction& other);
+        void MoveFrom(BasicInplaceFunction& other) noexcept;
+
+        mutable std::aligned_storage_t<N, Alignment> buffer_;
+        Invoker invoker_{&details::inplace_function::InvokeEmpty<R, Args...>};
+        const Operations* operations_{nullptr};
+    };
+
+
+    // Implementation
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::BasicInplaceFunction(std::nullptr_t) noexcept {}
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::BasicInplaceFunction(const BasicInplaceFunction& other)
+    requires Copyable {
+        CopyFrom(other);
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::BasicInplaceFunction(BasicInplaceFunction&& other) noexcept {
+        MoveFrom(other);
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>&
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::operator=(const BasicInplaceFunction& other)
+    requires Copyable {
+        if (this != &other) {
+            Reset();
+            CopyFrom(other);
+        }
+        return *this;
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>&
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::operator=(BasicInplaceFunction&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    template<typename F, typename>
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::BasicInplaceFunction(F&& callable) {
+        Construct(std::forward<F>(callable));
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    template<typename F, typename>
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>&
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::operator=(F&& callable) {
+        Reset();
+        Construct(std::forward<F>(callable));
+        return *this;
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    R BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::operator()(Args... args) const {
+        return invoker_(&buffer_, std::forward<Args>(args)...);
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    void BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::Reset() noexcept {
+        if (operations_ && operations_->destroy_) {
+            operations_->destroy_(&buffer_);
+        }
+        invoker_ = &details::inplace_function::InvokeEmpty<R, Args...>;
+        operations_ = nullptr;
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::operator bool() const noexcept {
+        return operations_ != nullptr;
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::~BasicInplaceFunction() {
+        Reset();
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    constexpr std::size_t BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::GetCapacity() noexcept {
+        return N;
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    template<typename F>
+    void BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::Construct(F&& callable) {
+        using T = DecayF<F>;
+
+        new(&buffer_) T(std::forward<F>(callable));
+        invoker_ = &details::inplace_function::Invoke<T, R, Args...>;
+        operations_ = details::inplace_any::kOperations<T>;
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    void BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::CopyFrom(const BasicInplaceFunction& other) {
+        if (!other.operations_) {
+            return;
+        }
+        if (other.operations_->copy_) {
+            other.operations_->copy_(&buffer_, &other.buffer_);
+        } else {
+            std::memcpy(&buffer_, &other.buffer_, N);
+        }
+        invoker_ = other.invoker_;
+        operations_ = other.operations_;
+    }
+
+    template<typename R, typename... Args, std::size_t N, std::size_t Alignment, bool Copyable>
+    void BasicInplaceFunction<R(Args...), N, Alignment, Copyable>::MoveFrom(BasicInplaceFunction& other) noexcept {
+        if (!other.operations_) {
+            return;
+        }
+        if (other.operations_->move_) {
+            other.operations_->move_(&buffer_, &other.buffer_);
+        } else {
+            std::memcpy(&buffer_, &other.buffer_, N);
+        }
+        invoker_ = other.invoker_;
+        operations_ = other.operations_;
+        other.Reset();
+    }
+
+} // End of namespace fast_containers
+
+#endif //FAST_CONTAINERS_INPLACE_FUNCTION_H
@@ -0,0 +1,474 @@
+#ifndef FAST_CONTAINERS_INPLACE_SORTED_MAP_H
+#define FAST_CONTAINERS_INPLACE_SORTED_MAP_H
+
+#include <span>
+#include <array>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <concepts>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+namespace fast_containers {
+
+    namespace details::inplace_sorted_map {
+
+        // Keys are searched in the blocks of 16, a block of 4 bytes keys is one cache line
+        inline constexpr std::size_t kBlockSize = 16;
+
+        inline constexpr std::size_t GetBlocksCount(std::size_t n) noexcept {
+            return (n + kBlockSize - 1u) / kBlockSize;
+        }
+
+        // 4 and 8 bytes integers are compared with SIMD, other keys are found by the branchless binary search
+        template<typename K>
+        inline constexpr bool kIsSimdKey = std::is_integral_v<K> && !std::is_same_v<K, bool> &&
+                                           (sizeof(K) == 4 || sizeof(K) == 8);
+
+        // Number of the keys of the block that are less than the key. The comparison masks are -1 in the matched
+        // lanes, they are subtracted from the counters, so there is no popcnt, that is not a part of SSE4.2 and AVX2
+        template<typename K>
+        inline std::size_t CountLess(const K* keys, K key) noexcept {
+#if defined(__AVX2__) || defined(__SSE4_2__)
+            using Signed = std::make_signed_t<K>;
+            // Signed comparison of unsigned keys is the comparison with the flipped sign bits
+            constexpr Signed kFlip = std::is_signed_v<K> ? Signed(0) : std::numeric_limits<Signed>::min();
+            const auto needle = static_cast<Signed>(static_cast<Signed>(key) ^ kFlip);
+#endif
+#if defined(__AVX2__)
+            constexpr std::size_t kLanes = 32 / sizeof(K);
+            __m256i counters = _mm256_setzero_si256();
+            for (std::size_t i = 0; i < kBlockSize; i += kLanes) {
+                const auto block = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + i));
+                if constexpr (sizeof(K) == 4) {
+                    const auto flipped = _mm256_xor_si256(block, _mm256_set1_epi32(kFlip));
+                    counters = _mm256_sub_epi32(counters, _mm256_cmpgt_epi32(_mm256_set1_epi32(needle), flipped));
+                } else {
+                    const auto flipped = _mm256_xor_si256(block, _mm256_set1_epi64x(kFlip));
+                    counters = _mm256_sub_epi64(counters, _mm256_cmpgt_epi64(_mm256_set1_epi64x(needle), flipped));
+                }
+            }
+            __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(counters), _mm256_extracti128_si256(counters, 1));
+#elif defined(__SSE4_2__)
+            constexpr std::size_t kLanes = 16 / sizeof(K);
+            __m128i sum = _mm_setzero_si128();
+            for (std::size_t i = 0; i < kBlockSize; i += kLanes) {
+                const auto block = _mm_load_si128(reinterpret_cast<const __m128i*>(keys + i));
+                if constexpr (sizeof(K) == 4) {
+                    const auto flipped = _mm_xor_si128(block, _mm_set1_epi32(kFlip));
+                    sum = _mm_sub_epi32(sum, _mm_cmpgt_epi32(_mm_set1_epi32(needle), flipped));
+                } else {
+                    const auto flipped = _mm_xor_si128(block, _mm_set1_epi64x(kFlip));
+                    sum = _mm_sub_epi64(sum, _mm_cmpgt_epi64(_mm_set1_epi64x(needle), flipped));
+                }
+            }
+#endif
+#if defined(__AVX2__) || defined(__SSE4_2__)
+            // The counters are at most kBlockSize, so the 32 bits lanes are summed as the 64 bits ones
+            if constexpr (sizeof(K) == 4) {
+                sum = _mm_add_epi32(sum, _mm_srli_epi64(sum, 32));
+            }
+            sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+            return static_cast<std::size_t>(static_cast<uint32_t>(_mm_cvtsi128_si32(sum)));
+#else
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < kBlockSize; i++) {
+                count += static_cast<std::size_t>(keys[i] < key);
+            }
+            return count;
+#endif
+        }
+
+        struct NoSummary {};
+
+    } // End of namespace fast_containers::details::inplace_sorted_map
+
+
+    // Sorted flat map of up to N keys in the inplace arrays, keys and values are stored separately, so the search
+    // reads only the keys. Integer keys of 4 and 8 bytes are searched in two SIMD steps: the summary of the last keys
+    // of the blocks of 16 finds the block, then the block finds the position. Unused keys are the maximum value,
+    // so the blocks are always full. For N <= 256 and 4 bytes keys a search reads two cache lines. Other keys are
+    // found by the branchless binary search. InsertSorted and Erase move the tails with std::memmove.
+    // Not thread safe
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    class InplaceSortedMap {
+    private:
+        static constexpr std::size_t kBlockSize = details::inplace_sorted_map::kBlockSize;
+        static constexpr std::size_t kBlocksCount = details::inplace_sorted_map::GetBlocksCount(N);
+        static constexpr std::size_t kPaddedCapacity = kBlocksCount * kBlockSize;
+        static constexpr std::size_t kSummarySize = details::inplace_sorted_map::GetBlocksCount(kBlocksCount) *
+                                                    kBlockSize;
+        static constexpr bool kIsSimd = details::inplace_sorted_map::kIsSimdKey<K>;
+        static constexpr std::size_t kAlignment = kIsSimd ? 64u : alignof(K);
+
+    public:
+        using KeyType = K;
+        using MappedType = V;
+
+        InplaceSortedMap() noexcept;
+
+        InplaceSortedMap(const InplaceSortedMap&) = default;
+        InplaceSortedMap& operator=(const InplaceSortedMap&) = default;
+
+        // Returns false and keeps the value if the key is already in the map
+        bool InsertSorted(const K& key, const V& value);
+
+        // Inserts or replaces the value, returns the reference to it
+        V& InsertOrAssign(const K& key, const V& value);
+
+        // Returns false if the key is not in the map
+        bool Erase(const K& key) noexcept;
+        void EraseAt(std::size_t index) noexcept;
+
+        // nullptr if the key is not in the map
+        [[nodiscard]] V* Find(const K& key) noexcept;
+        [[nodiscard]] const V* Find(const K& key) const noexcept;
+
+        [[nodiscard]] bool Contains(const K& key) const noexcept;
+
+        // Index of the first key not less than the key and of the first key greater than the key, Size() if none
+        [[nodiscard]] std::size_t LowerBound(const K& key) const noexcept;
+        [[nodiscard]] std::size_t UpperBound(const K& key) const noexcept;
+
+        [[nodiscard]] const K& GetKey(std::size_t index) const noexcept;
+        [[nodiscard]] V& GetValue(std::size_t index) noexcept;
+        [[nodiscard]] const V& GetValue(std::size_t index) const noexcept;
+
+        // The sorted keys and their values, the spans are invalidated by InsertSorted and Erase
+        [[nodiscard]] std::span<const K> GetKeys() const noexcept;
+        [[nodiscard]] std::span<V> GetValues() noexcept;
+        [[nodiscard]] std::span<const V> GetValues() const noexcept;
+
+        // Calls function(key, value) for every key in the ascending order
+        template<typename Function>
+        void ForEach(Function&& function);
+
+        template<typename Function>
+        void ForEach(Function&& function) const;
+
+        // Calls function(key, value) for the keys from [first, last) in the ascending order
+        template<typename Function>
+        void ForEach(const K& first, const K& last, Function&& function);
+
+        template<typename Function>
+        void ForEach(const K& first, const K& last, Function&& function) const;
+
+        void Clear() noexcept;
+
+        [[nodiscard]] std::size_t Size() const noexcept;
+        [[nodiscard]] bool Empty() const noexcept;
+
+        static constexpr std::size_t GetCapacity() noexcept;
+
+        ~InplaceSortedMap() = default;
+
+    private:
+        // Moves the tail and refreshes the summary of the changed blocks
+        void InsertAt(std::size_t index, const K& key, const V& value) noexcept;
+        void UpdateSummary(std::size_t first, std::size_t last) noexcept;
+
+        using Summary = std::conditional_t<kIsSimd, std::array<K, kSummarySize>,
+                details::inplace_sorted_map::NoSummary>;
+
+        alignas(kAlignment) std::array<K, kPaddedCapacity> keys_;
+        // Follows the whole blocks of the keys, so it is aligned as well
+        [[no_unique_address]] Summary summary_;
+        std::array<V, N> values_{};
+        std::size_t size_{0};
+    };
+
+
+    // Implementation
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    InplaceSortedMap<K, V, N>::InplaceSortedMap() noexcept {
+        Clear();
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    bool InplaceSortedMap<K, V, N>::InsertSorted(const K& key, const V& value) {
+        const std::size_t index = LowerBound(key);
+        if (index != size_ && keys_[index] == key) {
+            return false;
+        }
+        if (size_ == N) {
+            throw std::length_error("InplaceSortedMap capacity is exceeded");
+        }
+        InsertAt(index, key, value);
+        return true;
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    V& InplaceSortedMap<K, V, N>::InsertOrAssign(const K& key, const V& value) {
+        const std::size_t index = LowerBound(key);
+        if (index != size_ && keys_[index] == key) {
+            values_[index] = value;
+            return values_[index];
+        }
+        if (size_ == N) {
+            throw std::length_error("InplaceSortedMap capacity is exceeded");
+        }
+        InsertAt(index, key, value);
+        return values_[index];
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    bool InplaceSortedMap<K, V, N>::Erase(const K& key) noexcept {
+        const std::size_t index = LowerBound(key);
+        if (index == size_ || keys_[index] != key) {
+            return false;
+        }
+        EraseAt(index);
+        return true;
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    void InplaceSortedMap<K, V, N>::EraseAt(std::size_t index) noexcept {
+        const std::size_t tail = size_ - index - 1u;
+        std::memmove(keys_.data() + index, keys_.data() + index + 1u, tail * sizeof(K));
+        std::memmove(values_.data() + index, values_.data() + index + 1u, tail * sizeof(V));
+        size_--;
+        if constexpr (kIsSimd) {
+            keys_[size_] = std::numeric_limits<K>::max();
+            UpdateSummary(index, size_);
+        }
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    V* InplaceSortedMap<K, V, N>::Find(const K& key) noexcept {
+        const std::size_t index = LowerBound(key);
+        return index != size_ && keys_[index] == key ? &values_[index] : nullptr;
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    const V* InplaceSortedMap<K, V, N>::Find(const K& key) const noexcept {
+        const std::size_t index = LowerBound(key);
+        return index != size_ && keys_[index] == key ? &values_[index] : nullptr;
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    bool InplaceSortedMap<K, V, N>::Contains(const K& key) const noexcept {
+        return Find(key) != nullptr;
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    std::size_t InplaceSortedMap<K, V, N>::LowerBound(const K& key) const noexcept {
+        if constexpr (kIsSimd) {
+            using details::inplace_sorted_map::CountLess;
+            // The blocks whose last key is less than the key are skipped
+            std::size_t block = 0;
+            for (std::size_t i = 0; i < kSummarySize; i += kBlockSize) {
+                block += CountLess(summary_.data() + i, key);
+            }
+            // All blocks are skipped only if the map is full and the key is greater than all keys
+            block = std::min(block, kBlocksCount - 1u);
+            const std::size_t first = block * kBlockSize;
+            return first + CountLess(keys_.data() + first, key);
+        } else {
+            if (size_ == 0) {
+                return 0;
+            }
+            // The result is in [base, base + length], the comparison compiles to cmov
+            const K* base = keys_.data();
+            std::size_t length = size_;
+            while (length > 1u) {
+                const std::size_t half = length / 2u;
+                base = base[half] < key ? base + half : base;
+                length -= half;
+            }
+            return std::size_t(base - keys_.data()) + static_cast<std::size_t>(*base < key);
+        }
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    std::size_t InplaceSortedMap<K, V, N>::UpperBound(const K& key) const noexcept {
+        if constexpr (kIsSimd) {
+            return key == std::numeric_limits<K>::max() ? size_ : LowerBound(K(key + 1));
+        } else {
+            if (size_ == 0) {
+                return 0;
+            }
+            const K* base = keys_.data();
+            std::size_t length = size_;
+            while (length > 1u) {
+                const std::size_t half = length / 2u;
+                base = key < base[half] ? base : base + half;
+                length -= half;
+            }
+            return std::size_t(base - keys_.data()) + static_cast<std::size_t>(!(key < *base));
+        }
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    const K& InplaceSortedMap<K, V, N>::GetKey(std::size_t index) const noexcept {
+        return keys_[index];
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    V& InplaceSortedMap<K, V, N>::GetValue(std::size_t index) noexcept {
+        return values_[index];
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    const V& InplaceSortedMap<K, V, N>::GetValue(std::size_t index) const noexcept {
+        return values_[index];
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    std::span<const K> InplaceSortedMap<K, V, N>::GetKeys() const noexcept {
+        return {keys_.data(), size_};
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    std::span<V> InplaceSortedMap<K, V, N>::GetValues() noexcept {
+        return {values_.data(), size_};
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    std::span<const V> InplaceSortedMap<K, V, N>::GetValues() const noexcept {
+        return {values_.data(), size_};
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    template<typename Function>
+    void InplaceSortedMap<K, V, N>::ForEach(Function&& function) {
+        for (std::size_t i = 0; i < size_; i++) {
+            function(keys_[i], values_[i]);
+        }
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    template<typename Function>
+    void InplaceSortedMap<K, V, N>::ForEach(Function&& function) const {
+        for (std::size_t i = 0; i < size_; i++) {
+            function(keys_[i], values_[i]);
+        }
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    template<typename Function>
+    void InplaceSortedMap<K, V, N>::ForEach(const K& first, const K& last, Function&& function) {
+        const std::size_t end = LowerBound(last);
+        for (std::size_t i = LowerBound(first); i < end; i++) {
+            function(keys_[i], values_[i]);
+        }
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    template<typename Function>
+    void InplaceSortedMap<K, V, N>::ForEach(const K& first, const K& last, Function&& function) const {
+        const std::size_t end = LowerBound(last);
+        for (std::size_t i = LowerBound(first); i < end; i++) {
+            function(keys_[i], values_[i]);
+        }
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    void InplaceSortedMap<K, V, N>::Clear() noexcept {
+        if constexpr (kIsSimd) {
+            keys_.fill(std::numeric_limits<K>::max());
+            summary_.fill(std::numeric_limits<K>::max());
+        } else {
+            keys_.fill(K{});
+        }
+        size_ = 0;
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    std::size_t InplaceSortedMap<K, V, N>::Size() const noexcept {
+        return size_;
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    bool InplaceSortedMap<K, V, N>::Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    constexpr std::size_t InplaceSortedMap<K, V, N>::GetCapacity() noexcept {
+        return N;
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    void InplaceSortedMap<K, V, N>::InsertAt(std::size_t index, const K& key, const V& value) noexcept {
+        const std::size_t tail = size_ - index;
+        std::memmove(keys_.data() + index + 1u, keys_.data() + index, tail * sizeof(K));
+        std::memmove(values_.data() + index + 1u, values_.data() + index, tail * sizeof(V));
+        keys_[index] = key;
+        values_[index] = value;
+        size_++;
+        if constexpr (kIsSimd) {
+            UpdateSummary(index, size_ - 1u);
+        }
+    }
+
+    template<typename K, typename V, std::size_t N>
+    requires (N > 0) && std::totally_ordered<K> && std::is_trivially_copyable_v<K> &&
+             std::is_trivially_copyable_v<V> && std::default_initializable<K> && std::default_initializable<V>
+    void InplaceSortedMap<K, V, N>::UpdateSummary(std::size_t first, std::size_t last) noexcept {
+        // Keys from [first, last] have moved, the summary keeps the last key of every block
+        for (std::size_t block = first / kBlockSize; block <= last / kBlockSize; block++) {
+            summary_[block] = keys_[block * kBlockSize + kBlockSize - 1u];
+        }
+    }
+
+} // End of namespace fast_containers
+
+#endif //FAST_CONTAINERS_INPLACE_SORTED_MAP_H
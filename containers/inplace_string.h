@@ -0,0 +1,331 @@
+#ifndef FAST_CONTAINERS_INPLACE_STRING_H
+#define FAST_CONTAINERS_INPLACE_STRING_H
+
+#include <bit>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <compare>
+#include <stdexcept>
+#include <string_view>
+#include <functional>
+
+#include "hash.h"
+
+namespace fast_containers {
+
+    namespace details::inplace_string {
+
+        using Word = uint64_t;
+        using SizeType = uint8_t;
+
+        inline constexpr std::size_t kWordSize = sizeof(Word);
+
+        // Data bytes and the length byte are rounded up to the whole number of words
+        template<std::size_t N>
+        inline constexpr std::size_t kStorageSize = ((N + sizeof(SizeType) + kWordSize - 1u) / kWordSize) * kWordSize;
+
+        inline Word LoadWord(const char* pointer) noexcept {
+            Word word;
+            std::memcpy(&word, pointer, kWordSize);
+            return word;
+        }
+
+        inline Word LoadBigEndianWord(const char* pointer) noexcept {
+            if constexpr (std::endian::native == std::endian::little) {
+                return __builtin_bswap64(LoadWord(pointer));
+            } else {
+                return LoadWord(pointer);
+            }
+        }
+
+    } // End of namespace fast_containers::details::inplace_string
+
+
+    // Layout: [data bytes][zero padding][length byte]
+    // Padding is always zeroed, so comparison and hashing work on whole words without length-dependent loops.
+    // The length byte is the last byte of the last word, so big-endian word comparison is lexicographic.
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    class InplaceString {
+    private:
+        using Word = details::inplace_string::Word;
+        using SizeType = details::inplace_string::SizeType;
+
+        static constexpr std::size_t kWordSize = details::inplace_string::kWordSize;
+        static constexpr std::size_t kStorageSize = details::inplace_string::kStorageSize<N>;
+        static constexpr std::size_t kWordsCount = kStorageSize / kWordSize;
+        static constexpr std::size_t kSizeIndex = kStorageSize - 1u;
+
+    public:
+        using Iterator = char*;
+        using ConstIterator = const char*;
+
+        InplaceString() = default;
+
+        InplaceString(const char* str);
+        InplaceString(const char* str, std::size_t size);
+        InplaceString(std::string_view str);
+
+        InplaceString(const InplaceString&) = default;
+        InplaceString& operator=(const InplaceString&) = default;
+
+        InplaceString& operator=(std::string_view str);
+
+        void Assign(const char* str, std::size_t size);
+
+        void Append(std::string_view str);
+        void PushBack(char c);
+        void PopBack() noexcept;
+        void Clear() noexcept;
+
+        [[nodiscard]] char& operator[](std::size_t index) noexcept;
+        [[nodiscard]] const char& operator[](std::size_t index) const noexcept;
+
+        [[nodiscard]] char* Data() noexcept;
+        [[nodiscard]] const char* Data() const noexcept;
+
+        [[nodiscard]] std::size_t Size() const noexcept;
+        [[nodiscard]] bool Empty() const noexcept;
+
+        [[nodiscard]] std::string_view View() const noexcept;
+        operator std::string_view() const noexcept;
+
+        Iterator begin() noexcept;
+        Iterator end() noexcept;
+        ConstIterator begin() const noexcept;
+        ConstIterator end() const noexcept;
+
+        [[nodiscard]] std::size_t Hash() const noexcept;
+
+        static constexpr std::size_t GetCapacity() noexcept;
+
+        template<std::size_t M>
+        friend bool operator==(const InplaceString<M>& lhs, const InplaceString<M>& rhs) noexcept;
+
+        template<std::size_t M>
+        friend std::strong_ordering operator<=>(const InplaceString<M>& lhs, const InplaceString<M>& rhs) noexcept;
+
+        ~InplaceString() = default;
+
+    private:
+        void SetSize(std::size_t size) noexcept;
+
+        [[nodiscard]] Word GetWord(std::size_t index) const noexcept;
+
+        alignas(Word) std::array<char, kStorageSize> buffer_{};
+    };
+
+    template<std::size_t N>
+    bool operator==(const InplaceString<N>& lhs, const InplaceString<N>& rhs) noexcept;
+
+    template<std::size_t N>
+    std::strong_ordering operator<=>(const InplaceString<N>& lhs, const InplaceString<N>& rhs) noexcept;
+
+
+    // Implementation
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    InplaceString<N>::InplaceString(const char* str) : InplaceString(std::string_view{str}) {}
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    InplaceString<N>::InplaceString(const char* str, std::size_t size) {
+        Assign(str, size);
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    InplaceString<N>::InplaceString(std::string_view str) {
+        Assign(str.data(), str.size());
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    InplaceString<N>& InplaceString<N>::operator=(std::string_view str) {
+        Assign(str.data(), str.size());
+        return *this;
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    void InplaceString<N>::Assign(const char* str, std::size_t size) {
+        if (size > N) {
+            throw std::length_error("InplaceString capacity is exceeded");
+        }
+        // The source may be the own data, so it is moved before the padding is zeroed
+        std::memmove(buffer_.data(), str, size);
+        std::memset(buffer_.data() + size, 0, kStorageSize - size);
+        SetSize(size);
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    void InplaceString<N>::Append(std::string_view str) {
+        const std::size_t size = Size();
+        if (str.size() > N - size) {
+            throw std::length_error("InplaceString capacity is exceeded");
+        }
+        std::memcpy(buffer_.data() + size, str.data(), str.size());
+        SetSize(size + str.size());
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    void InplaceString<N>::PushBack(char c) {
+        const std::size_t size = Size();
+        if (size == N) {
+            throw std::length_error("InplaceString capacity is exceeded");
+        }
+        buffer_[size] = c;
+        SetSize(size + 1u);
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    void InplaceString<N>::PopBack() noexcept {
+        assert(!Empty() && "InplaceString is empty");
+        const std::size_t size = Size() - 1u;
+        buffer_[size] = 0;
+        SetSize(size);
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    void InplaceString<N>::Clear() noexcept {
+        buffer_.fill(0);
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    char& InplaceString<N>::operator[](std::size_t index) noexcept {
+        return buffer_[index];
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    const char& InplaceString<N>::operator[](std::size_t index) const noexcept {
+        return buffer_[index];
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    char* InplaceString<N>::Data() noexcept {
+        return buffer_.data();
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    const char* InplaceString<N>::Data() const noexcept {
+        return buffer_.data();
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    std::size_t InplaceString<N>::Size() const noexcept {
+        return static_cast<unsigned char>(buffer_[kSizeIndex]);
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    bool InplaceString<N>::Empty() const noexcept {
+        return Size() == 0;
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    std::string_view InplaceString<N>::View() const noexcept {
+        return {buffer_.data(), Size()};
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    InplaceString<N>::operator std::string_view() const noexcept {
+        return View();
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    InplaceString<N>::Iterator InplaceString<N>::begin() noexcept {
+        return buffer_.data();
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    InplaceString<N>::Iterator InplaceString<N>::end() noexcept {
+        return buffer_.data() + Size();
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    InplaceString<N>::ConstIterator InplaceString<N>::begin() const noexcept {
+        return buffer_.data();
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    InplaceString<N>::ConstIterator InplaceString<N>::end() const noexcept {
+        return buffer_.data() + Size();
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    std::size_t InplaceString<N>::Hash() const noexcept {
+        // The whole storage is hashed, so the size is a compile time constant and the length byte is included
+        return utils::WyHash(buffer_.data(), kStorageSize);
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    constexpr std::size_t InplaceString<N>::GetCapacity() noexcept {
+        return N;
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    void InplaceString<N>::SetSize(std::size_t size) noexcept {
+        buffer_[kSizeIndex] = static_cast<char>(size);
+    }
+
+    template<std::size_t N>
+    requires (N > 0) && (N <= std::numeric_limits<details::inplace_string::SizeType>::max())
+    InplaceString<N>::Word InplaceString<N>::GetWord(std::size_t index) const noexcept {
+        return details::inplace_string::LoadWord(buffer_.data() + index * kWordSize);
+    }
+
+    template<std::size_t N>
+    bool operator==(const InplaceString<N>& lhs, const InplaceString<N>& rhs) noexcept {
+        using Word = details::inplace_string::Word;
+        Word difference = 0;
+        for (std::size_t i = 0; i < InplaceString<N>::kWordsCount; i++) {
+            difference |= lhs.GetWord(i) ^ rhs.GetWord(i);
+        }
+        return difference == 0;
+    }
+
+    template<std::size_t N>
+    std::strong_ordering operator<=>(const InplaceString<N>& lhs, const InplaceString<N>& rhs) noexcept {
+        using namespace details::inplace_string;
+        for (std::size_t i = 0; i < InplaceString<N>::kWordsCount; i++) {
+            const std::size_t offset = i * kWordSize;
+            const Word lhs_word = LoadBigEndianWord(lhs.buffer_.data() + offset);
+            const Word rhs_word = LoadBigEndianWord(rhs.buffer_.data() + offset);
+            if (lhs_word != rhs_word) {
+                return lhs_word <=> rhs_word;
+            }
+        }
+        return std::strong_ordering::equal;
+    }
+
+} // End of namespace fast_containers
+
+template<std::size_t N>
+struct std::hash<fast_containers::InplaceString<N>> {
+    std::size_t operator()(const fast_containers::InplaceString<N>& str) const noexcept {
+        return str.Hash();
+    }
+};
+
+#endif //FAST_CONTAINERS_INPLACE_STRING_H
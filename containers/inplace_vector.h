@@ -0,0 +1,905 @@
+#ifndef FAST_CONTAINERS_INPLACE_VECTOR_H
+#define FAST_CONTAINERS_INPLACE_VECTOR_H
+
+#include <array>
+#include <memory>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+namespace fast_containers {
+
+    namespace details::inplace_vector {
+
+        template<typename T, typename Allocator>
+        struct Rebind {
+            using Type = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+        };
+
+        struct NoAllocator {};
+
+        template<typename T>
+        struct Rebind<T, void> {
+            using Type = NoAllocator;
+        };
+
+        // The heap storage of the vector that outgrew the inplace buffer, heap_ is nullptr while the buffer is used
+        template<typename T, typename Allocator>
+        struct Overflow {
+            Overflow() = default;
+            explicit Overflow(const Allocator& allocator) noexcept : allocator_(allocator) {}
+
+            T* heap_{nullptr};
+            std::size_t capacity_{0};
+            [[no_unique_address]] Allocator allocator_;
+        };
+
+        template<typename T>
+        struct Overflow<T, NoAllocator> {};
+
+        // Whether the move assignment never allocates, as for std::vector the heap storage can be taken
+        // only if the allocator propagates or all the allocators are equal
+        template<typename Allocator>
+        inline constexpr bool kIsNothrowMoveAssignable =
+                std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                std::allocator_traits<Allocator>::is_always_equal::value;
+
+        template<>
+        inline constexpr bool kIsNothrowMoveAssignable<NoAllocator> = true;
+
+    } // End of namespace fast_containers::details::inplace_vector
+
+
+    // std::vector with the inplace buffer of N elements. Without OverflowAllocator the capacity is N and
+    // the operations that exceed it throw std::length_error, so nothing is ever allocated. With OverflowAllocator
+    // (std::allocator or the allocators of fast_containers::allocators) the elements move to the heap storage
+    // when the buffer is exhausted. Trivially copyable elements are copied, moved and shifted with std::memcpy
+    // and std::memmove. Elements must be nothrow move constructible. The move assignment with an allocator that
+    // is not equal to the other one and does not propagate (e.g. std::pmr) allocates and may throw.
+    // Not thread safe
+    template<typename T, std::size_t N, typename OverflowAllocator = void>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    class InplaceVector {
+    private:
+        using Allocator = typename details::inplace_vector::Rebind<T, OverflowAllocator>::Type;
+        using Overflow = details::inplace_vector::Overflow<T, Allocator>;
+
+        static constexpr bool kCanOverflow = !std::is_void_v<OverflowAllocator>;
+        static constexpr bool kIsTrivial = std::is_trivially_copyable_v<T>;
+        static constexpr bool kIsTriviallyDestructible = std::is_trivially_destructible_v<T> && !kCanOverflow;
+        static constexpr bool kIsNothrowMoveAssignable = details::inplace_vector::kIsNothrowMoveAssignable<Allocator>;
+
+    public:
+        using ValueType = T;
+        using Iterator = T*;
+        using ConstIterator = const T*;
+        using ReverseIterator = std::reverse_iterator<Iterator>;
+        using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+        InplaceVector() = default;
+
+        explicit InplaceVector(const Allocator& allocator) noexcept requires (kCanOverflow);
+
+        explicit InplaceVector(std::size_t count);
+        InplaceVector(std::size_t count, const T& value);
+
+        template<std::input_iterator InputIterator>
+        InplaceVector(InputIterator first, InputIterator last);
+
+        InplaceVector(std::initializer_list<T> values);
+
+        InplaceVector(const InplaceVector& other);
+        InplaceVector(InplaceVector&& other) noexcept;
+
+        InplaceVector& operator=(const InplaceVector& other);
+        InplaceVector& operator=(InplaceVector&& other) noexcept(kIsNothrowMoveAssignable);
+        InplaceVector& operator=(std::initializer_list<T> values);
+
+        void Assign(std::size_t count, const T& value);
+
+        template<std::input_iterator InputIterator>
+        void Assign(InputIterator first, InputIterator last);
+
+        void Assign(std::initializer_list<T> values);
+
+        // Throws std::out_of_range
+        [[nodiscard]] T& At(std::size_t index);
+        [[nodiscard]] const T& At(std::size_t index) const;
+
+        [[nodiscard]] T& operator[](std::size_t index) noexcept;
+        [[nodiscard]] const T& operator[](std::size_t index) const noexcept;
+
+        [[nodiscard]] T& Front() noexcept;
+        [[nodiscard]] const T& Front() const noexcept;
+        [[nodiscard]] T& Back() noexcept;
+        [[nodiscard]] const T& Back() const noexcept;
+
+        [[nodiscard]] T* Data() noexcept;
+        [[nodiscard]] const T* Data() const noexcept;
+
+        Iterator begin() noexcept;
+        Iterator end() noexcept;
+        ConstIterator begin() const noexcept;
+        ConstIterator end() const noexcept;
+        ConstIterator cbegin() const noexcept;
+        ConstIterator cend() const noexcept;
+        ReverseIterator rbegin() noexcept;
+        ReverseIterator rend() noexcept;
+        ConstReverseIterator rbegin() const noexcept;
+        ConstReverseIterator rend() const noexcept;
+
+        [[nodiscard]] bool Empty() const noexcept;
+        [[nodiscard]] std::size_t Size() const noexcept;
+
+        // N while the inplace buffer is used
+        [[nodiscard]] std::size_t Capacity() const noexcept;
+        [[nodiscard]] bool IsInplace() const noexcept;
+
+        void Reserve(std::size_t capacity);
+
+        // Moves the elements back to the inplace buffer if they fit
+        void ShrinkToFit();
+
+        void Clear() noexcept;
+
+        Iterator Insert(ConstIterator position, const T& value);
+        Iterator Insert(ConstIterator position, T&& value);
+        Iterator Insert(ConstIterator position, std::size_t count, const T& value);
+
+        template<std::input_iterator InputIterator>
+        Iterator Insert(ConstIterator position, InputIterator first, InputIterator last);
+
+        Iterator Insert(ConstIterator position, std::initializer_list<T> values);
+
+        template<typename... Args>
+        Iterator Emplace(ConstIterator position, Args&&... args);
+
+        Iterator Erase(ConstIterator position) noexcept;
+        Iterator Erase(ConstIterator first, ConstIterator last) noexcept;
+
+        void PushBack(const T& value);
+        void PushBack(T&& value);
+
+        template<typename... Args>
+        T& EmplaceBack(Args&&... args);
+
+        void PopBack() noexcept;
+
+        void Resize(std::size_t count);
+        void Resize(std::size_t count, const T& value);
+
+        void Swap(InplaceVector& other) noexcept(kIsNothrowMoveAssignable);
+
+        [[nodiscard]] Allocator GetAllocator() const noexcept requires (kCanOverflow);
+
+        static constexpr std::size_t GetInplaceCapacity() noexcept;
+
+        ~InplaceVector() requires (kIsTriviallyDestructible) = default;
+        ~InplaceVector() requires (!kIsTriviallyDestructible);
+
+    private:
+        static Overflow SelectOnCopy(const Overflow& other) noexcept;
+
+        [[nodiscard]] T* GetBuffer() noexcept;
+        [[nodiscard]] const T* GetBuffer() const noexcept;
+
+        // Throws std::length_error without OverflowAllocator
+        void Grow(std::size_t size);
+        void Reallocate(std::size_t capacity);
+        void ReleaseHeap() noexcept;
+
+        template<typename... Args>
+        T& EmplaceBackSlow(Args&&... args);
+
+        // Moves the elements from [index, Size()) count positions to the right, the gap is not constructed
+        T* OpenGap(std::size_t index, std::size_t count);
+        void CloseGap(std::size_t index, std::size_t count) noexcept;
+
+        // Moves the elements of the other vector, the other vector is left empty. Allocates if they don't fit
+        // into the buffer, which happens only in the move assignment with the allocators that are not equal
+        void MoveElementsFrom(InplaceVector& other);
+
+        // Move constructs count elements at the destination and destroys the sources, the ranges may overlap
+        static void Relocate(T* destination, T* source, std::size_t count) noexcept;
+
+        alignas(T) std::array<std::byte, N * sizeof(T)> buffer_;
+        std::size_t size_{0};
+        [[no_unique_address]] Overflow overflow_;
+    };
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    bool operator==(const InplaceVector<T, N, OverflowAllocator>& lhs,
+                    const InplaceVector<T, N, OverflowAllocator>& rhs);
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    std::compare_three_way_result_t<T> operator<=>(const InplaceVector<T, N, OverflowAllocator>& lhs,
+                                                   const InplaceVector<T, N, OverflowAllocator>& rhs);
+
+
+    // Implementation
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::InplaceVector(const Allocator& allocator) noexcept requires (kCanOverflow)
+            : overflow_(allocator) {}
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::InplaceVector(std::size_t count) {
+        Resize(count);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::InplaceVector(std::size_t count, const T& value) {
+        Resize(count, value);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    template<std::input_iterator InputIterator>
+    InplaceVector<T, N, OverflowAllocator>::InplaceVector(InputIterator first, InputIterator last) {
+        Assign(first, last);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::InplaceVector(std::initializer_list<T> values) {
+        Assign(values.begin(), values.end());
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::InplaceVector(const InplaceVector& other)
+            : overflow_(SelectOnCopy(other.overflow_)) {
+        Grow(other.size_);
+        if constexpr (kIsTrivial) {
+            std::memcpy(Data(), other.Data(), other.size_ * sizeof(T));
+        } else {
+            std::uninitialized_copy_n(other.Data(), other.size_, Data());
+        }
+        size_ = other.size_;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::InplaceVector(InplaceVector&& other) noexcept
+            : overflow_(other.overflow_) {
+        if constexpr (kCanOverflow) {
+            // The heap storage is taken as is
+            if (other.overflow_.heap_ != nullptr) {
+                other.overflow_.heap_ = nullptr;
+                other.overflow_.capacity_ = 0;
+                std::swap(size_, other.size_);
+                return;
+            }
+        }
+        MoveElementsFrom(other);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>& InplaceVector<T, N, OverflowAllocator>::operator=(const InplaceVector& other) {
+        if (this != &other) {
+            Clear();
+            if constexpr (kCanOverflow) {
+                using Traits = std::allocator_traits<Allocator>;
+                if constexpr (Traits::propagate_on_container_copy_assignment::value) {
+                    if (overflow_.allocator_ != other.overflow_.allocator_) {
+                        ReleaseHeap();
+                    }
+                    overflow_.allocator_ = other.overflow_.allocator_;
+                }
+            }
+            Assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>& InplaceVector<T, N, OverflowAllocator>::operator=(InplaceVector&& other)
+            noexcept(kIsNothrowMoveAssignable) {
+        if (this != &other) {
+            Clear();
+            ReleaseHeap();
+            if constexpr (kCanOverflow) {
+                using Traits = std::allocator_traits<Allocator>;
+                if constexpr (Traits::propagate_on_container_move_assignment::value) {
+                    overflow_.allocator_ = std::move(other.overflow_.allocator_);
+                }
+                if (other.overflow_.heap_ != nullptr && overflow_.allocator_ == other.overflow_.allocator_) {
+                    std::swap(overflow_.heap_, other.overflow_.heap_);
+                    std::swap(overflow_.capacity_, other.overflow_.capacity_);
+                    std::swap(size_, other.size_);
+                    return *this;
+                }
+            }
+            MoveElementsFrom(other);
+        }
+        return *this;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>& InplaceVector<T, N, OverflowAllocator>::operator=(std::initializer_list<T> values) {
+        Assign(values.begin(), values.end());
+        return *this;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::Assign(std::size_t count, const T& value) {
+        // The value may be the element of the vector
+        const T copy = value;
+        Clear();
+        Resize(count, copy);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    template<std::input_iterator InputIterator>
+    void InplaceVector<T, N, OverflowAllocator>::Assign(InputIterator first, InputIterator last) {
+        Clear();
+        Insert(end(), first, last);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::Assign(std::initializer_list<T> values) {
+        Assign(values.begin(), values.end());
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    T& InplaceVector<T, N, OverflowAllocator>::At(std::size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("InplaceVector index is out of range");
+        }
+        return Data()[index];
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    const T& InplaceVector<T, N, OverflowAllocator>::At(std::size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("InplaceVector index is out of range");
+        }
+        return Data()[index];
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    T& InplaceVector<T, N, OverflowAllocator>::operator[](std::size_t index) noexcept {
+        return Data()[index];
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    const T& InplaceVector<T, N, OverflowAllocator>::operator[](std::size_t index) const noexcept {
+        return Data()[index];
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    T& InplaceVector<T, N, OverflowAllocator>::Front() noexcept {
+        return Data()[0];
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    const T& InplaceVector<T, N, OverflowAllocator>::Front() const noexcept {
+        return Data()[0];
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    T& InplaceVector<T, N, OverflowAllocator>::Back() noexcept {
+        return Data()[size_ - 1u];
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    const T& InplaceVector<T, N, OverflowAllocator>::Back() const noexcept {
+        return Data()[size_ - 1u];
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    T* InplaceVector<T, N, OverflowAllocator>::Data() noexcept {
+        if constexpr (kCanOverflow) {
+            return overflow_.heap_ != nullptr ? overflow_.heap_ : GetBuffer();
+        } else {
+            return GetBuffer();
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    const T* InplaceVector<T, N, OverflowAllocator>::Data() const noexcept {
+        if constexpr (kCanOverflow) {
+            return overflow_.heap_ != nullptr ? overflow_.heap_ : GetBuffer();
+        } else {
+            return GetBuffer();
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::Iterator InplaceVector<T, N, OverflowAllocator>::begin() noexcept {
+        return Data();
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::Iterator InplaceVector<T, N, OverflowAllocator>::end() noexcept {
+        return Data() + size_;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::ConstIterator InplaceVector<T, N, OverflowAllocator>::begin() const noexcept {
+        return Data();
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::ConstIterator InplaceVector<T, N, OverflowAllocator>::end() const noexcept {
+        return Data() + size_;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::ConstIterator InplaceVector<T, N, OverflowAllocator>::cbegin() const noexcept {
+        return begin();
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::ConstIterator InplaceVector<T, N, OverflowAllocator>::cend() const noexcept {
+        return end();
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::ReverseIterator InplaceVector<T, N, OverflowAllocator>::rbegin() noexcept {
+        return ReverseIterator{end()};
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::ReverseIterator InplaceVector<T, N, OverflowAllocator>::rend() noexcept {
+        return ReverseIterator{begin()};
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::ConstReverseIterator
+    InplaceVector<T, N, OverflowAllocator>::rbegin() const noexcept {
+        return ConstReverseIterator{end()};
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::ConstReverseIterator
+    InplaceVector<T, N, OverflowAllocator>::rend() const noexcept {
+        return ConstReverseIterator{begin()};
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    bool InplaceVector<T, N, OverflowAllocator>::Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    std::size_t InplaceVector<T, N, OverflowAllocator>::Size() const noexcept {
+        return size_;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    std::size_t InplaceVector<T, N, OverflowAllocator>::Capacity() const noexcept {
+        if constexpr (kCanOverflow) {
+            return overflow_.heap_ != nullptr ? overflow_.capacity_ : N;
+        } else {
+            return N;
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    bool InplaceVector<T, N, OverflowAllocator>::IsInplace() const noexcept {
+        if constexpr (kCanOverflow) {
+            return overflow_.heap_ == nullptr;
+        } else {
+            return true;
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::Reserve(std::size_t capacity) {
+        if (capacity <= Capacity()) {
+            return;
+        }
+        if constexpr (kCanOverflow) {
+            Reallocate(capacity);
+        } else {
+            throw std::length_error("InplaceVector capacity is exceeded");
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::ShrinkToFit() {
+        if constexpr (kCanOverflow) {
+            if (overflow_.heap_ == nullptr || size_ == overflow_.capacity_) {
+                return;
+            }
+            if (size_ > N) {
+                Reallocate(size_);
+                return;
+            }
+            Relocate(GetBuffer(), overflow_.heap_, size_);
+            std::allocator_traits<Allocator>::deallocate(overflow_.allocator_, overflow_.heap_, overflow_.capacity_);
+            overflow_.heap_ = nullptr;
+            overflow_.capacity_ = 0;
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::Clear() noexcept {
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::Iterator
+    InplaceVector<T, N, OverflowAllocator>::Insert(ConstIterator position, const T& value) {
+        return Emplace(position, value);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::Iterator
+    InplaceVector<T, N, OverflowAllocator>::Insert(ConstIterator position, T&& value) {
+        return Emplace(position, std::move(value));
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::Iterator
+    InplaceVector<T, N, OverflowAllocator>::Insert(ConstIterator position, std::size_t count, const T& value) {
+        const auto index = std::size_t(position - Data());
+        const T copy = value;
+        T* gap = OpenGap(index, count);
+        try {
+            std::uninitialized_fill_n(gap, count, copy);
+        } catch (...) {
+            CloseGap(index, count);
+            throw;
+        }
+        size_ += count;
+        return Data() + index;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    template<std::input_iterator InputIterator>
+    InplaceVector<T, N, OverflowAllocator>::Iterator
+    InplaceVector<T, N, OverflowAllocator>::Insert(ConstIterator position, InputIterator first, InputIterator last) {
+        const auto index = std::size_t(position - Data());
+        if constexpr (std::forward_iterator<InputIterator>) {
+            const auto count = std::size_t(std::distance(first, last));
+            T* gap = OpenGap(index, count);
+            if constexpr (kIsTrivial && std::contiguous_iterator<InputIterator> &&
+                          std::is_same_v<std::iter_value_t<InputIterator>, T>) {
+                if (count) {
+                    std::memcpy(gap, std::to_address(first), count * sizeof(T));
+                }
+            } else {
+                try {
+                    std::uninitialized_copy(first, last, gap);
+                } catch (...) {
+                    CloseGap(index, count);
+                    throw;
+                }
+            }
+            size_ += count;
+        } else {
+            for (std::size_t i = index; first != last; ++first, i++) {
+                Emplace(Data() + i, *first);
+            }
+        }
+        return Data() + index;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::Iterator
+    InplaceVector<T, N, OverflowAllocator>::Insert(ConstIterator position, std::initializer_list<T> values) {
+        return Insert(position, values.begin(), values.end());
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    template<typename... Args>
+    InplaceVector<T, N, OverflowAllocator>::Iterator
+    InplaceVector<T, N, OverflowAllocator>::Emplace(ConstIterator position, Args&&... args) {
+        const auto index = std::size_t(position - Data());
+        if (index == size_) {
+            return &EmplaceBack(std::forward<Args>(args)...);
+        }
+        // The arguments may refer to the elements that are moved by the gap
+        T value(std::forward<Args>(args)...);
+        T* gap = OpenGap(index, 1u);
+        std::construct_at(gap, std::move(value));
+        size_++;
+        return gap;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::Iterator
+    InplaceVector<T, N, OverflowAllocator>::Erase(ConstIterator position) noexcept {
+        return Erase(position, position + 1);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::Iterator
+    InplaceVector<T, N, OverflowAllocator>::Erase(ConstIterator first, ConstIterator last) noexcept {
+        T* data = Data();
+        const auto index = std::size_t(first - data);
+        const auto count = std::size_t(last - first);
+        std::destroy_n(data + index, count);
+        Relocate(data + index, data + index + count, size_ - index - count);
+        size_ -= count;
+        return data + index;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    template<typename... Args>
+    T& InplaceVector<T, N, OverflowAllocator>::EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) [[unlikely]] {
+            return EmplaceBackSlow(std::forward<Args>(args)...);
+        }
+        T* element = std::construct_at(Data() + size_, std::forward<Args>(args)...);
+        size_++;
+        return *element;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::PopBack() noexcept {
+        size_--;
+        std::destroy_at(Data() + size_);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::Resize(std::size_t count) {
+        if (count <= size_) {
+            std::destroy(Data() + count, Data() + size_);
+        } else {
+            Grow(count);
+            std::uninitialized_value_construct(Data() + size_, Data() + count);
+        }
+        size_ = count;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::Resize(std::size_t count, const T& value) {
+        if (count <= size_) {
+            std::destroy(Data() + count, Data() + size_);
+            size_ = count;
+        } else {
+            Insert(end(), count - size_, value);
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::Swap(InplaceVector& other) noexcept(kIsNothrowMoveAssignable) {
+        InplaceVector temporary{std::move(other)};
+        other = std::move(*this);
+        *this = std::move(temporary);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::Allocator
+    InplaceVector<T, N, OverflowAllocator>::GetAllocator() const noexcept requires (kCanOverflow) {
+        return overflow_.allocator_;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    constexpr std::size_t InplaceVector<T, N, OverflowAllocator>::GetInplaceCapacity() noexcept {
+        return N;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::~InplaceVector() requires (!kIsTriviallyDestructible) {
+        Clear();
+        ReleaseHeap();
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    InplaceVector<T, N, OverflowAllocator>::Overflow
+    InplaceVector<T, N, OverflowAllocator>::SelectOnCopy(const Overflow& other) noexcept {
+        if constexpr (kCanOverflow) {
+            return Overflow{std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator_)};
+        } else {
+            return other;
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    T* InplaceVector<T, N, OverflowAllocator>::GetBuffer() noexcept {
+        return reinterpret_cast<T*>(buffer_.data());
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    const T* InplaceVector<T, N, OverflowAllocator>::GetBuffer() const noexcept {
+        return reinterpret_cast<const T*>(buffer_.data());
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::Grow(std::size_t size) {
+        if (size <= Capacity()) {
+            return;
+        }
+        if constexpr (kCanOverflow) {
+            Reallocate(std::max(2u * Capacity(), size));
+        } else {
+            throw std::length_error("InplaceVector capacity is exceeded");
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::Reallocate(std::size_t capacity) {
+        if constexpr (kCanOverflow) {
+            using Traits = std::allocator_traits<Allocator>;
+            T* heap = Traits::allocate(overflow_.allocator_, capacity);
+            Relocate(heap, Data(), size_);
+            ReleaseHeap();
+            overflow_.heap_ = heap;
+            overflow_.capacity_ = capacity;
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::ReleaseHeap() noexcept {
+        if constexpr (kCanOverflow) {
+            if (overflow_.heap_ != nullptr) {
+                std::allocator_traits<Allocator>::deallocate(overflow_.allocator_, overflow_.heap_, overflow_.capacity_);
+                overflow_.heap_ = nullptr;
+                overflow_.capacity_ = 0;
+            }
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    template<typename... Args>
+    T& InplaceVector<T, N, OverflowAllocator>::EmplaceBackSlow(Args&&... args) {
+        if constexpr (kCanOverflow) {
+            using Traits = std::allocator_traits<Allocator>;
+            // The new element is constructed first, the arguments may refer to the old elements
+            const std::size_t capacity = 2u * Capacity();
+            T* heap = Traits::allocate(overflow_.allocator_, capacity);
+            try {
+                std::construct_at(heap + size_, std::forward<Args>(args)...);
+            } catch (...) {
+                Traits::deallocate(overflow_.allocator_, heap, capacity);
+                throw;
+            }
+            Relocate(heap, Data(), size_);
+            ReleaseHeap();
+            overflow_.heap_ = heap;
+            overflow_.capacity_ = capacity;
+            return heap[size_++];
+        } else {
+            throw std::length_error("InplaceVector capacity is exceeded");
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    T* InplaceVector<T, N, OverflowAllocator>::OpenGap(std::size_t index, std::size_t count) {
+        Grow(size_ + count);
+        T* data = Data();
+        Relocate(data + index + count, data + index, size_ - index);
+        return data + index;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::CloseGap(std::size_t index, std::size_t count) noexcept {
+        T* data = Data();
+        Relocate(data + index, data + index + count, size_ - index);
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::MoveElementsFrom(InplaceVector& other) {
+        // The elements of the other vector fit into the buffer, the heap of the other vector is kept by it
+        if constexpr (kCanOverflow) {
+            if (other.size_ > N) {
+                using Traits = std::allocator_traits<Allocator>;
+                overflow_.heap_ = Traits::allocate(overflow_.allocator_, other.size_);
+                overflow_.capacity_ = other.size_;
+            }
+        }
+        Relocate(Data(), other.Data(), other.size_);
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    requires (N > 0) && std::is_nothrow_move_constructible_v<T>
+    void InplaceVector<T, N, OverflowAllocator>::Relocate(T* destination, T* source, std::size_t count) noexcept {
+        if (count == 0 || destination == source) {
+            return;
+        }
+        if constexpr (kIsTrivial) {
+            std::memmove(destination, source, count * sizeof(T));
+        } else if (destination < source) {
+            for (std::size_t i = 0; i < count; i++) {
+                std::construct_at(destination + i, std::move(source[i]));
+                std::destroy_at(source + i);
+            }
+        } else {
+            for (std::size_t i = count; i > 0; i--) {
+                std::construct_at(destination + i - 1u, std::move(source[i - 1u]));
+                std::destroy_at(source + i - 1u);
+            }
+        }
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    bool operator==(const InplaceVector<T, N, OverflowAllocator>& lhs,
+                    const InplaceVector<T, N, OverflowAllocator>& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<typename T, std::size_t N, typename OverflowAllocator>
+    std::compare_three_way_result_t<T> operator<=>(const InplaceVector<T, N, OverflowAllocator>& lhs,
+                                                   const InplaceVector<T, N, OverflowAllocator>& rhs) {
+        return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+} // End of namespace fast_containers
+
+#endif //FAST_CONTAINERS_INPLACE_VECTOR_H
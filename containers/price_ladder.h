@@ -0,0 +1,417 @@
+#ifndef FAST_CONTAINERS_PRICE_LADDER_H
+#define FAST_CONTAINERS_PRICE_LADDER_H
+
+#include <new>
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "id_object_pool.h"
+#include "hierarchical_bitset.h"
+#include "inline_storage.h"
+
+namespace fast_containers {
+
+    enum class BookSide {
+        kBid, // The best price is the highest one
+        kAsk, // The best price is the lowest one
+    };
+
+    using OrderId = ContainerElementId;
+
+    namespace details::price_ladder {
+
+        template<typename T>
+        struct OrderNode : IdObjectPoolElementBase {
+            template<typename... Args>
+            OrderNode(int64_t price, uint64_t quantity, Args&&... args) : price_(price), quantity_(quantity),
+                                                                          value_(std::forward<Args>(args)...) {}
+
+            int64_t price_;
+            uint64_t quantity_;
+            OrderNode* previous_{nullptr};
+            OrderNode* next_{nullptr};
+            ContainerElementId id_{0};
+            T value_;
+        };
+
+        // FIFO of the orders of the price level
+        template<typename T>
+        struct Level {
+            OrderNode<T>* head_{nullptr};
+            OrderNode<T>* tail_{nullptr};
+            uint64_t quantity_{0};
+            std::size_t orders_count_{0};
+        };
+
+    } // End of namespace fast_containers::details::price_ladder
+
+    // Aggregated price level
+    struct PriceLevel {
+        int64_t price_{0};
+        uint64_t quantity_{0};
+        std::size_t orders_count_{0};
+    };
+
+    // One side of the order book over the fixed window of Levels prices (in ticks) from the anchor.
+    // Every level is the intrusive FIFO of the orders in the time priority, orders live in the inplace IdObjectPool
+    // of MaxOrders. The occupancy HierarchicalBitset finds the best level and the next one with a couple of bit scans.
+    // Prices outside the window are rejected, Recenter moves the window when the prices drift.
+    // Not thread safe
+    template<typename T,
+            BookSide Side,
+            std::size_t Levels,
+            std::size_t MaxOrders,
+            typename StoragePolicy = allocators::InlineStoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    class PriceLadder {
+    private:
+        using Node = details::price_ladder::OrderNode<T>;
+        using Level = details::price_ladder::Level<T>;
+        using Bitmap = HierarchicalBitset<Levels>;
+
+    public:
+        // The window is [min_price, min_price + Levels)
+        explicit PriceLadder(int64_t min_price = 0) noexcept;
+
+        PriceLadder(const PriceLadder&) = delete;
+        PriceLadder(PriceLadder&&) = delete;
+        PriceLadder& operator=(const PriceLadder&) = delete;
+        PriceLadder& operator=(PriceLadder&&) = delete;
+
+        // Adds the order to the end of its level. Throws std::out_of_range if the price is outside the window
+        // and std::bad_alloc if MaxOrders orders are already added
+        template<typename... Args>
+        OrderId Add(int64_t price, uint64_t quantity, Args&&... args);
+
+        // Returns false if the order has already been removed
+        bool Cancel(OrderId id) noexcept;
+
+        // Reduces the quantity keeping the time priority, removes the order if nothing is left
+        void Reduce(OrderId id, uint64_t quantity) noexcept;
+
+        [[nodiscard]] bool Contains(OrderId id);
+
+        T* Get(OrderId id);
+        [[nodiscard]] int64_t GetPrice(OrderId id);
+        [[nodiscard]] uint64_t GetQuantity(OrderId id);
+
+        [[nodiscard]] std::optional<int64_t> GetBestPrice() const noexcept;
+
+        // The next worse occupied price after the price: lower for the bids, higher for the asks
+        [[nodiscard]] std::optional<int64_t> GetNextPrice(int64_t price) const noexcept;
+
+        // Empty level if the price is outside the window
+        [[nodiscard]] PriceLevel GetLevel(int64_t price) const noexcept;
+
+        // The oldest order of the level, 0 if the level is empty
+        [[nodiscard]] OrderId Front(int64_t price) const noexcept;
+
+        // Calls function(OrderId, uint64_t quantity, T&) for the orders of the level in the time priority.
+        // The function may cancel or reduce the current order
+        template<typename Function>
+        void ForEachOrder(int64_t price, Function&& function);
+
+        // Moves the window, so it starts at min_price. Returns false and keeps the window if an order is outside
+        // the new one. O(Levels / 64 + the occupied range), the levels are moved in place
+        bool Recenter(int64_t min_price) noexcept;
+
+        [[nodiscard]] int64_t GetMinPrice() const noexcept;
+        [[nodiscard]] int64_t GetMaxPrice() const noexcept;
+
+        [[nodiscard]] std::size_t Size() const noexcept;
+        [[nodiscard]] bool Empty() const noexcept;
+
+        ~PriceLadder();
+
+    private:
+        [[nodiscard]] bool IsInWindow(int64_t price) const noexcept;
+        [[nodiscard]] std::size_t GetIndex(int64_t price) const noexcept;
+
+        void Remove(Node* node) noexcept;
+
+    private:
+        IdObjectPool<Node, MaxOrders, StoragePolicy> pool_;
+        std::array<Level, Levels> levels_{};
+        Bitmap occupancy_;
+        int64_t min_price_;
+        std::size_t size_{0};
+    };
+
+    template<typename T, std::size_t Levels, std::size_t MaxOrders,
+            typename StoragePolicy = allocators::InlineStoragePolicy>
+    using BidLadder = PriceLadder<T, BookSide::kBid, Levels, MaxOrders, StoragePolicy>;
+
+    template<typename T, std::size_t Levels, std::size_t MaxOrders,
+            typename StoragePolicy = allocators::InlineStoragePolicy>
+    using AskLadder = PriceLadder<T, BookSide::kAsk, Levels, MaxOrders, StoragePolicy>;
+
+
+    // Implementation
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::PriceLadder(int64_t min_price) noexcept
+            : min_price_(min_price) {}
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    template<typename... Args>
+    OrderId PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::Add(int64_t price, uint64_t quantity,
+                                                                        Args&&... args) {
+        if (!IsInWindow(price)) {
+            throw std::out_of_range("Price is outside the ladder window");
+        }
+        if (size_ == MaxOrders) {
+            throw std::bad_alloc();
+        }
+
+        const OrderId id = pool_.Construct(price, quantity, std::forward<Args>(args)...);
+        Node* node = pool_.Get(id);
+        node->id_ = id;
+
+        const std::size_t index = GetIndex(price);
+        Level& level = levels_[index];
+        node->previous_ = level.tail_;
+        if (level.tail_) {
+            level.tail_->next_ = node;
+        } else {
+            level.head_ = node;
+            occupancy_.Insert(index);
+        }
+        level.tail_ = node;
+        level.quantity_ += quantity;
+        level.orders_count_++;
+        size_++;
+        return id;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    bool PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::Cancel(OrderId id) noexcept {
+        if (!pool_.Contains(id)) {
+            return false;
+        }
+        Remove(pool_.Get(id));
+        return true;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    void PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::Reduce(OrderId id, uint64_t quantity) noexcept {
+        Node* node = pool_.Get(id);
+        if (quantity >= node->quantity_) {
+            Remove(node);
+            return;
+        }
+        node->quantity_ -= quantity;
+        levels_[GetIndex(node->price_)].quantity_ -= quantity;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    bool PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::Contains(OrderId id) {
+        return pool_.Contains(id);
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    T* PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::Get(OrderId id) {
+        return &pool_.Get(id)->value_;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    int64_t PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::GetPrice(OrderId id) {
+        return pool_.Get(id)->price_;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    uint64_t PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::GetQuantity(OrderId id) {
+        return pool_.Get(id)->quantity_;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    std::optional<int64_t> PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::GetBestPrice() const noexcept {
+        const std::size_t index = Side == BookSide::kBid ? occupancy_.Max() : occupancy_.Min();
+        if (index == Bitmap::kNone) {
+            return std::nullopt;
+        }
+        return min_price_ + int64_t(index);
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    std::optional<int64_t> PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::GetNextPrice(int64_t price) const noexcept {
+        std::size_t index;
+        if (price < min_price_) {
+            index = Side == BookSide::kBid ? Bitmap::kNone : occupancy_.Min();
+        } else if (price >= GetMaxPrice() + 1) {
+            index = Side == BookSide::kBid ? occupancy_.Max() : Bitmap::kNone;
+        } else {
+            index = Side == BookSide::kBid ? occupancy_.Predecessor(GetIndex(price))
+                                           : occupancy_.Successor(GetIndex(price));
+        }
+        if (index == Bitmap::kNone) {
+            return std::nullopt;
+        }
+        return min_price_ + int64_t(index);
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    PriceLevel PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::GetLevel(int64_t price) const noexcept {
+        if (!IsInWindow(price)) {
+            return PriceLevel{price, 0, 0};
+        }
+        const Level& level = levels_[GetIndex(price)];
+        return PriceLevel{price, level.quantity_, level.orders_count_};
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    OrderId PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::Front(int64_t price) const noexcept {
+        if (!IsInWindow(price)) {
+            return 0;
+        }
+        const Node* head = levels_[GetIndex(price)].head_;
+        return head ? head->id_ : 0u;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    template<typename Function>
+    void PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::ForEachOrder(int64_t price, Function&& function) {
+        if (!IsInWindow(price)) {
+            return;
+        }
+        Node* node = levels_[GetIndex(price)].head_;
+        while (node) {
+            Node* next = node->next_;
+            function(node->id_, node->quantity_, node->value_);
+            node = next;
+        }
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    bool PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::Recenter(int64_t min_price) noexcept {
+        const std::size_t first = occupancy_.Min();
+        if (first != Bitmap::kNone) {
+            const int64_t lowest = min_price_ + int64_t(first);
+            const int64_t highest = min_price_ + int64_t(occupancy_.Max());
+            if (lowest < min_price || highest >= min_price + int64_t(Levels)) {
+                return false;
+            }
+        }
+
+        const int64_t shift = min_price - min_price_;
+        min_price_ = min_price;
+        if (first == Bitmap::kNone || shift == 0) {
+            return true;
+        }
+
+        // Orders keep their prices, only the occupied range of the levels moves in place
+        const std::size_t last = occupancy_.Max() + 1u;
+        Level* begin = levels_.data();
+        std::size_t new_first;
+        if (shift > 0) {
+            new_first = first - std::size_t(shift);
+            std::move(begin + first, begin + last, begin + new_first);
+            std::fill(begin + std::max(first, last - std::size_t(shift)), begin + last, Level{});
+        } else {
+            new_first = first + std::size_t(-shift);
+            std::move_backward(begin + first, begin + last, begin + last + std::size_t(-shift));
+            std::fill(begin + first, begin + std::min(last, new_first), Level{});
+        }
+
+        occupancy_.Clear();
+        for (std::size_t i = new_first; i < new_first + (last - first); i++) {
+            if (levels_[i].head_) {
+                occupancy_.Insert(i);
+            }
+        }
+        return true;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    int64_t PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::GetMinPrice() const noexcept {
+        return min_price_;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    int64_t PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::GetMaxPrice() const noexcept {
+        return min_price_ + int64_t(Levels) - 1;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    std::size_t PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::Size() const noexcept {
+        return size_;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    bool PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::~PriceLadder() {
+        for (auto& level : levels_) {
+            Node* node = level.head_;
+            while (node) {
+                Node* next = node->next_;
+                pool_.Destroy(node->id_);
+                node = next;
+            }
+        }
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    bool PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::IsInWindow(int64_t price) const noexcept {
+        return price >= min_price_ && price - min_price_ < int64_t(Levels);
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    std::size_t PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::GetIndex(int64_t price) const noexcept {
+        return std::size_t(price - min_price_);
+    }
+
+    template<typename T, BookSide Side, std::size_t Levels, std::size_t MaxOrders, typename StoragePolicy>
+    requires (Levels > 0) && allocators::IsStoragePolicy<StoragePolicy>
+    void PriceLadder<T, Side, Levels, MaxOrders, StoragePolicy>::Remove(Node* node) noexcept {
+        const std::size_t index = GetIndex(node->price_);
+        Level& level = levels_[index];
+        if (node->previous_) {
+            node->previous_->next_ = node->next_;
+        } else {
+            level.head_ = node->next_;
+        }
+        if (node->next_) {
+            node->next_->previous_ = node->previous_;
+        } else {
+            level.tail_ = node->previous_;
+        }
+        if (!level.head_) {
+            occupancy_.Erase(index);
+        }
+        level.quantity_ -= node->quantity_;
+        level.orders_count_--;
+        size_--;
+        pool_.Destroy(node->id_);
+    }
+
+} // End of namespace fast_containers
+
+#endif //FAST_CONTAINERS_PRICE_LADDER_H
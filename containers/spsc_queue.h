@@ -0,0 +1,214 @@
+#ifndef FAST_CONTAINERS_SPSC_QUEUE_H
+#define FAST_CONTAINERS_SPSC_QUEUE_H
+
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "utils.h"
+#include "inplace_any.h"
+
+namespace fast_containers {
+
+    namespace details::spsc_queue {
+
+        inline constexpr std::size_t kCacheLineSize = 64;
+        inline constexpr std::size_t kDefaultMessageSize = 48;
+        inline constexpr std::size_t kDefaultMessageAlignment = alignof(std::max_align_t);
+
+    } // End of namespace fast_containers::details::spsc_queue
+
+    using MessageType = uint32_t;
+
+    // Slot of the SpscQueue: user defined type tag and trivially copyable payload
+    template<std::size_t N, std::size_t Alignment>
+    struct SpscMessage {
+        MessageType type_{0};
+        InplaceTrivialAny<N, Alignment> payload_;
+    };
+
+    template<std::size_t Capacity,
+            std::size_t N = details::spsc_queue::kDefaultMessageSize,
+            std::size_t Alignment = details::spsc_queue::kDefaultMessageAlignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    class SpscQueue {
+    private:
+        static constexpr std::size_t kCacheLineSize = details::spsc_queue::kCacheLineSize;
+        static constexpr std::size_t kMask = Capacity - 1u;
+
+    public:
+        using Message = SpscMessage<N, Alignment>;
+
+        SpscQueue() = default;
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue(SpscQueue&&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+        SpscQueue& operator=(SpscQueue&&) = delete;
+
+        // Producer
+        template<typename T>
+        bool TryPush(MessageType type, const T& payload) noexcept;
+
+        // Publishes the longest prefix of messages that fits with a single release store, returns its size.
+        // The consumer index is reloaded if the cached one leaves fewer than count free slots
+        std::size_t TryPushN(const Message* messages, std::size_t count) noexcept;
+
+        // Consumer
+        [[nodiscard]] const Message* Front() noexcept;
+        void Pop() noexcept;
+
+        bool TryPop(Message& message) noexcept;
+
+        // Calls handler(const Message&) for every message published so far, releases the slots with a single store
+        template<typename Handler>
+        std::size_t ConsumeAll(Handler&& handler);
+
+        // Both sides
+        [[nodiscard]] std::size_t Size() const noexcept;
+        [[nodiscard]] bool Empty() const noexcept;
+
+        static constexpr std::size_t GetCapacity() noexcept;
+
+        ~SpscQueue() = default;
+
+    private:
+        // The remote index is reloaded only if the cached one gives fewer than required slots
+        std::size_t GetFreeSlots(std::size_t tail, std::size_t required = 1u) noexcept;
+        std::size_t GetReadySlots(std::size_t head, std::size_t required = 1u) noexcept;
+
+        // Consumer cache line
+        alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+        std::size_t cached_tail_{0};
+
+        // Producer cache line
+        alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+        std::size_t cached_head_{0};
+
+        alignas(kCacheLineSize) std::array<Message, Capacity> buffer_;
+
+        static_assert(std::atomic<std::size_t>::is_always_lock_free, "Indices must be lock free");
+    };
+
+
+    // Implementation
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    template<typename T>
+    bool SpscQueue<Capacity, N, Alignment>::TryPush(MessageType type, const T& payload) noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (!GetFreeSlots(tail)) {
+            return false;
+        }
+        Message& message = buffer_[tail & kMask];
+        message.type_ = type;
+        message.payload_ = payload;
+        tail_.store(tail + 1u, std::memory_order_release);
+        return true;
+    }
+
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    std::size_t SpscQueue<Capacity, N, Alignment>::TryPushN(const Message* messages, std::size_t count) noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t pushed = std::min(count, GetFreeSlots(tail, count));
+        for (std::size_t i = 0; i < pushed; i++) {
+            buffer_[(tail + i) & kMask] = messages[i];
+        }
+        if (pushed) {
+            tail_.store(tail + pushed, std::memory_order_release);
+        }
+        return pushed;
+    }
+
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    const SpscQueue<Capacity, N, Alignment>::Message* SpscQueue<Capacity, N, Alignment>::Front() noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (!GetReadySlots(head)) {
+            return nullptr;
+        }
+        return &buffer_[head & kMask];
+    }
+
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    void SpscQueue<Capacity, N, Alignment>::Pop() noexcept {
+        head_.store(head_.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+    }
+
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    bool SpscQueue<Capacity, N, Alignment>::TryPop(Message& message) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (!GetReadySlots(head)) {
+            return false;
+        }
+        message = buffer_[head & kMask];
+        head_.store(head + 1u, std::memory_order_release);
+        return true;
+    }
+
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    template<typename Handler>
+    std::size_t SpscQueue<Capacity, N, Alignment>::ConsumeAll(Handler&& handler) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t ready = GetReadySlots(head, Capacity);
+        for (std::size_t i = 0; i < ready; i++) {
+            handler(static_cast<const Message&>(buffer_[(head + i) & kMask]));
+        }
+        if (ready) {
+            head_.store(head + ready, std::memory_order_release);
+        }
+        return ready;
+    }
+
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    std::size_t SpscQueue<Capacity, N, Alignment>::Size() const noexcept {
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : 0;
+    }
+
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    bool SpscQueue<Capacity, N, Alignment>::Empty() const noexcept {
+        return Size() == 0;
+    }
+
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    constexpr std::size_t SpscQueue<Capacity, N, Alignment>::GetCapacity() noexcept {
+        return Capacity;
+    }
+
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    std::size_t SpscQueue<Capacity, N, Alignment>::GetFreeSlots(std::size_t tail, std::size_t required) noexcept {
+        std::size_t free_slots = Capacity - (tail - cached_head_);
+        if (free_slots < required) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            free_slots = Capacity - (tail - cached_head_);
+        }
+        return free_slots;
+    }
+
+    template<std::size_t Capacity, std::size_t N, std::size_t Alignment>
+    requires fast_containers::utils::IsPowerOfTwo<Capacity>
+    std::size_t SpscQueue<Capacity, N, Alignment>::GetReadySlots(std::size_t head, std::size_t required) noexcept {
+        std::size_t ready_slots = cached_tail_ - head;
+        if (ready_slots < required) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            ready_slots = cached_tail_ - head;
+        }
+        return ready_slots;
+    }
+
+} // End of namespace fast_containers
+
+#endif //FAST_CONTAINERS_SPSC_QUEUE_H
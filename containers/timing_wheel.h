@@ -0,0 +1,354 @@
+#ifndef FAST_CONTAINERS_TIMING_WHEEL_H
+#define FAST_CONTAINERS_TIMING_WHEEL_H
+
+#include <new>
+#include <bit>
+#include <array>
+#include <limits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include "id_object_pool.h"
+#include "inline_storage.h"
+
+namespace fast_containers {
+
+    namespace details::timing_wheel {
+
+        inline constexpr std::size_t kDefaultLevels = 6;
+        inline constexpr std::size_t kDefaultSlotBits = 6;
+
+        // Timer of the wheel, lives in the IdObjectPool and is linked into the list of its slot
+        template<typename T>
+        struct TimerNode : IdObjectPoolElementBase {
+            template<typename... Args>
+            explicit TimerNode(uint64_t deadline, Args&&... args) : deadline_(deadline),
+                                                                    value_(std::forward<Args>(args)...) {}
+
+            uint64_t deadline_;
+            TimerNode* previous_{nullptr};
+            TimerNode* next_{nullptr};
+            ContainerElementId id_{0};
+            std::size_t slot_{0};
+            T value_;
+        };
+
+    } // End of namespace fast_containers::details::timing_wheel
+
+    using TimerId = ContainerElementId;
+
+    // Hierarchical timing wheel of at most N timers with the payload T. Time is measured in ticks of any resolution.
+    // Level l has 2^SlotBits slots of 2^(l * SlotBits) ticks, a timer is placed to the lowest level whose slot
+    // contains its deadline and moves one level down when the wheel reaches its slot (cascade). Timers further than
+    // 2^(Levels * SlotBits) ticks wait in the overflow list, it is rescanned once per the whole wheel turn.
+    // Schedule and Cancel are O(1), Advance is O(1) per fired or cascaded timer: empty slots are skipped by the
+    // occupancy bitmaps, so the idle ticks are free. Timers are taken from the inplace IdObjectPool, nothing is
+    // allocated after the construction.
+    // Not thread safe
+    template<typename T,
+            std::size_t N,
+            std::size_t Levels = details::timing_wheel::kDefaultLevels,
+            std::size_t SlotBits = details::timing_wheel::kDefaultSlotBits,
+            typename StoragePolicy = allocators::InlineStoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    class TimingWheel {
+    private:
+        using Node = details::timing_wheel::TimerNode<T>;
+
+        static constexpr std::size_t kSlotsCount = std::size_t(1) << SlotBits;
+        static constexpr uint64_t kSlotMask = kSlotsCount - 1u;
+        static constexpr std::size_t kHorizonBits = Levels * SlotBits;
+        static constexpr std::size_t kOverflowSlot = Levels * kSlotsCount;
+
+    public:
+        TimingWheel() = default;
+
+        // The first tick that has not been processed yet
+        explicit TimingWheel(uint64_t start_tick) noexcept;
+
+        TimingWheel(const TimingWheel&) = delete;
+        TimingWheel(TimingWheel&&) = delete;
+        TimingWheel& operator=(const TimingWheel&) = delete;
+        TimingWheel& operator=(TimingWheel&&) = delete;
+
+        // Constructs the payload from args. The deadline in the past fires on the next Advance.
+        // Throws std::bad_alloc if N timers are already scheduled
+        template<typename... Args>
+        TimerId Schedule(uint64_t deadline, Args&&... args);
+
+        // Returns false if the timer has already fired or has been cancelled
+        bool Cancel(TimerId id) noexcept;
+
+        [[nodiscard]] bool Contains(TimerId id);
+
+        T* Get(TimerId id);
+
+        // Fires every timer with the deadline <= now in the deadline order, calls handler(T&) with the payload.
+        // The timer is removed before the call, so the handler may schedule and cancel timers. A timer scheduled
+        // by the handler with the deadline <= now fires in the same call. Returns the number of fired timers
+        template<typename Handler>
+        std::size_t Advance(uint64_t now, Handler&& handler);
+
+        [[nodiscard]] uint64_t GetCurrentTick() const noexcept;
+
+        [[nodiscard]] std::size_t Size() const noexcept;
+        [[nodiscard]] bool Empty() const noexcept;
+
+        static constexpr std::size_t GetCapacity() noexcept;
+
+        ~TimingWheel();
+
+    private:
+        void Insert(Node* node) noexcept;
+        void Link(Node* node, std::size_t slot) noexcept;
+        void Unlink(Node* node) noexcept;
+        void Cascade(std::size_t slot) noexcept;
+
+        // The next tick that fires or cascades timers, max if the wheel is empty
+        [[nodiscard]] uint64_t GetNextEventTick() const noexcept;
+
+    private:
+        IdObjectPool<Node, N, StoragePolicy> pool_;
+        std::array<Node*, kOverflowSlot + 1u> slots_{};
+        std::array<uint64_t, Levels> occupancy_{};
+        uint64_t current_{0};
+        std::size_t size_{0};
+    };
+
+
+    // Implementation
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::TimingWheel(uint64_t start_tick) noexcept
+            : current_(start_tick) {}
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    template<typename... Args>
+    TimerId TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Schedule(uint64_t deadline, Args&&... args) {
+        if (size_ == N) {
+            throw std::bad_alloc();
+        }
+        const TimerId id = pool_.Construct(deadline, std::forward<Args>(args)...);
+        Node* node = pool_.Get(id);
+        node->id_ = id;
+        Insert(node);
+        size_++;
+        return id;
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    bool TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Cancel(TimerId id) noexcept {
+        if (!pool_.Contains(id)) {
+            return false;
+        }
+        Unlink(pool_.Get(id));
+        pool_.Destroy(id);
+        size_--;
+        return true;
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    bool TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Contains(TimerId id) {
+        return pool_.Contains(id);
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    T* TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Get(TimerId id) {
+        return &pool_.Get(id)->value_;
+    }
+
+    // Jumps over the ticks without events, a tick with events cascades the higher levels top down,
+    // so the timers of this tick reach level 0, and then fires level 0 slot
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    template<typename Handler>
+    std::size_t TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Advance(uint64_t now, Handler&& handler) {
+        std::size_t fired = 0;
+        while (current_ <= now) {
+            const uint64_t next = GetNextEventTick();
+            if (next > now) {
+                current_ = now + 1u;
+                break;
+            }
+            current_ = next;
+
+            if (slots_[kOverflowSlot] && (current_ & ((uint64_t(1) << kHorizonBits) - 1u)) == 0) {
+                Cascade(kOverflowSlot);
+            }
+            for (std::size_t level = Levels - 1u; level > 0; level--) {
+                const std::size_t shift = level * SlotBits;
+                if ((current_ & ((uint64_t(1) << shift) - 1u)) == 0) {
+                    Cascade(level * kSlotsCount + ((current_ >> shift) & kSlotMask));
+                }
+            }
+
+            const std::size_t slot = current_ & kSlotMask;
+            while (Node* node = slots_[slot]) {
+                Unlink(node);
+                T value = std::move(node->value_);
+                pool_.Destroy(node->id_);
+                size_--;
+                fired++;
+                handler(value);
+            }
+            current_++;
+        }
+        return fired;
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    uint64_t TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::GetCurrentTick() const noexcept {
+        return current_;
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    std::size_t TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Size() const noexcept {
+        return size_;
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    bool TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    constexpr std::size_t TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::GetCapacity() noexcept {
+        return N;
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::~TimingWheel() {
+        for (auto head : slots_) {
+            while (head) {
+                Node* next = head->next_;
+                pool_.Destroy(head->id_);
+                head = next;
+            }
+        }
+    }
+
+    // The highest bit where the deadline differs from the current tick selects the level,
+    // the deadline bits of the level select the slot
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    void TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Insert(Node* node) noexcept {
+        const uint64_t deadline = std::max(node->deadline_, current_);
+        const uint64_t difference = deadline ^ current_;
+        const std::size_t level = difference ? (std::bit_width(difference) - 1u) / SlotBits : 0u;
+        if (level >= Levels) {
+            Link(node, kOverflowSlot);
+        } else {
+            Link(node, level * kSlotsCount + ((deadline >> (level * SlotBits)) & kSlotMask));
+        }
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    void TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Link(Node* node, std::size_t slot) noexcept {
+        node->slot_ = slot;
+        node->previous_ = nullptr;
+        node->next_ = slots_[slot];
+        if (node->next_) {
+            node->next_->previous_ = node;
+        }
+        slots_[slot] = node;
+        if (slot != kOverflowSlot) {
+            occupancy_[slot / kSlotsCount] |= uint64_t(1) << (slot % kSlotsCount);
+        }
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    void TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Unlink(Node* node) noexcept {
+        if (node->previous_) {
+            node->previous_->next_ = node->next_;
+        } else {
+            slots_[node->slot_] = node->next_;
+            if (!node->next_ && node->slot_ != kOverflowSlot) {
+                occupancy_[node->slot_ / kSlotsCount] &= ~(uint64_t(1) << (node->slot_ % kSlotsCount));
+            }
+        }
+        if (node->next_) {
+            node->next_->previous_ = node->previous_;
+        }
+    }
+
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    void TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::Cascade(std::size_t slot) noexcept {
+        Node* node = slots_[slot];
+        slots_[slot] = nullptr;
+        if (slot != kOverflowSlot) {
+            occupancy_[slot / kSlotsCount] &= ~(uint64_t(1) << (slot % kSlotsCount));
+        }
+        while (node) {
+            Node* next = node->next_;
+            Insert(node);
+            node = next;
+        }
+    }
+
+    // A timer of level l > 0 is in a slot after the current one of its level, or in the current one if the current
+    // tick is the first tick of the slot and has not been processed yet. So the candidates are the first occupied
+    // slot of every level starting from the current tick
+    template<typename T, std::size_t N, std::size_t Levels, std::size_t SlotBits, typename StoragePolicy>
+    requires (Levels > 0) && (SlotBits > 0) && (SlotBits <= 6) && (Levels * SlotBits < 64) &&
+             allocators::IsStoragePolicy<StoragePolicy>
+    uint64_t TimingWheel<T, N, Levels, SlotBits, StoragePolicy>::GetNextEventTick() const noexcept {
+        uint64_t next = std::numeric_limits<uint64_t>::max();
+
+        if (const uint64_t bits = occupancy_[0] >> (current_ & kSlotMask)) {
+            next = current_ + std::countr_zero(bits);
+        }
+
+        for (std::size_t level = 1; level < Levels; level++) {
+            const std::size_t shift = level * SlotBits;
+            const bool slot_start = (current_ & ((uint64_t(1) << shift) - 1u)) == 0;
+            const uint64_t first_slot = ((current_ >> shift) & kSlotMask) + (slot_start ? 0u : 1u);
+            if (first_slot == kSlotsCount) {
+                continue;
+            }
+            if (const uint64_t bits = occupancy_[level] >> first_slot) {
+                const uint64_t turn = (current_ >> (shift + SlotBits)) << (shift + SlotBits);
+                next = std::min(next, turn + ((first_slot + std::countr_zero(bits)) << shift));
+            }
+        }
+
+        if (slots_[kOverflowSlot]) {
+            const uint64_t turn = current_ >> kHorizonBits;
+            const bool turn_start = (current_ & ((uint64_t(1) << kHorizonBits) - 1u)) == 0;
+            next = std::min(next, (turn_start ? turn : turn + 1u) << kHorizonBits);
+        }
+        return next;
+    }
+
+} // End of namespace fast_containers
+
+#endif //FAST_CONTAINERS_TIMING_WHEEL_H
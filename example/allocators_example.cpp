@@ -1,5 +1,10 @@
 #include <iostream>
+#include <vector>
+#include <map>
+#include <memory>
 #include "stack_allocator.h"
+#include "huge_page_arena.h"
+#include "monotonic_arena.h"
 
 namespace {
 
@@ -10,6 +15,56 @@ namespace {
 }
 
 int main() {
-    using Allocator = fast_containers::allocators::StackBasedAllocator<::CustomStruct, 1024>;
+    // Standard containers use the inplace buffer and fall back to the upstream when it is exhausted
+    using Resource = fast_containers::allocators::StackBasedMemoryResource<::CustomStruct, 1024>;
+    auto resource = std::make_unique<Resource>();
+
+    std::vector<CustomStruct, Resource::Allocator<CustomStruct>> structs{*resource};
+    for (size_t i = 0; i < 2000; i++) {
+        structs.push_back(CustomStruct{i, i, i});
+    }
+
+    std::map<int, int, std::less<>, Resource::Allocator<std::pair<const int, int>>> stack_map{*resource};
+    for (int i = 0; i < 100; i++) {
+        stack_map[i] = i;
+    }
+
+    std::pmr::vector<int> pmr_vector{resource.get()};
+    pmr_vector.assign(100, 1);
+
+    // Small containers share the huge pages of the arena
+    fast_containers::allocators::HugePageArena arena{};
+
+    std::vector<int, fast_containers::allocators::HugePageArenaAllocator<int>> vector{arena};
+    for (int i = 0; i < 10; i++) {
+        vector.push_back(i);
+    }
+
+    using Pair = std::pair<const int, CustomStruct>;
+    std::map<int, CustomStruct, std::less<>, fast_containers::allocators::HugePageArenaAllocator<Pair>> map{arena};
+    for (int i = 0; i < 1000; i++) {
+        map[i] = CustomStruct{1, 2, 3};
+    }
+
+    // Per-tick scratch data, no free calls on the hot path
+    fast_containers::allocators::MonotonicArena<1u << 12u> tick_arena{&arena};
+    for (int tick = 0; tick < 10; tick++) {
+        std::vector<int, decltype(tick_arena)::Allocator<int>> fields{tick_arena};
+        fields.assign(100, tick);
+        {
+            fast_containers::allocators::ScopedArenaMarker marker{tick_arena};
+            std::pmr::vector<CustomStruct> temporary{&tick_arena};
+            temporary.resize(1000);
+        }
+        tick_arena.Reset();
+    }
+
+    std::cout << "Mapped bytes: " << arena.GetMappedBytes() << std::endl;
+    std::cout << "Backing: " << fast_containers::allocators::ToString(arena.GetLastBacking()) << std::endl;
+
+    // 1 GiB pages bound to the NUMA node 0, falls back to 2 MiB and transparent huge pages
+    constexpr fast_containers::allocators::HugePagePolicy kPolicy{1u << 30u, true, true, 0};
+    std::vector<CustomStruct, fast_containers::allocators::HugePageAllocator<CustomStruct, kPolicy>> large(1u << 20u);
+    std::cout << "Backing: " << fast_containers::allocators::ToString(large.get_allocator().GetLastBacking()) << std::endl;
     return 0;
 }
@@ -1,9 +1,22 @@
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
 
 #include "inplace_any.h"
 
+struct Fee {
+    std::int64_t venue_;
+    std::int64_t fee_;
+};
+
+// Built at compile time, lives in .rodata
+constexpr fast_containers::InplaceTrivialAny<32, alignof(Fee)> kFee = Fee{3, -25};
+static_assert(kFee.GetValue<Fee>().fee_ == -25);
+
 int main() {
-    container::any::InplaceTrivialAny<32, alignof(int)> a = 5;
+    fast_containers::InplaceTrivialAny<32, alignof(int)> a = 5;
     assert(a.Get<int>() == 5);
     assert(a.Get<int>() != 10);
 
@@ -11,7 +24,7 @@ int main() {
     assert(a.Get<int>() != 5);
     assert(a.Get<int>() == 543);
 
-    container::any::InplaceTrivialAny<32, alignof(int)> b{a};
+    fast_containers::InplaceTrivialAny<32, alignof(int)> b{a};
     assert(b.Get<int>() != 5);
     assert(b.Get<int>() == 543);
 
@@ -23,5 +36,34 @@ int main() {
     assert(a.Get<int>() != 5);
     assert(a.Get<int>() != 20);
     assert(a.Get<int>() == 543);
+    assert(kFee.Get<Fee>().venue_ == 3);
+
+    // Non-trivial types
+    using Any = fast_containers::InplaceAny<32, alignof(std::max_align_t)>;
+
+    auto pointer = std::make_shared<int>(7);
+    Any c = pointer;
+    assert(c.Is<std::shared_ptr<int>>());
+    assert(pointer.use_count() == 2);
+
+    Any d{c};
+    assert(pointer.use_count() == 3);
+    assert(*d.Get<std::shared_ptr<int>>() == 7);
+
+    Any e{std::move(d)};
+    assert(!d.HasValue());
+    assert(pointer.use_count() == 3);
+
+    e = std::string("inplace");
+    assert(pointer.use_count() == 2);
+    assert(e.Get<std::string>() == "inplace");
+
+    c.Reset();
+    assert(pointer.use_count() == 1);
+
+    c = 42;
+    assert(c.Is<int>() && !c.Is<std::string>());
+    Any f = c;
+    assert(f.Get<int>() == 42);
     return 0;
 }
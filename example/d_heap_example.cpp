@@ -1,8 +1,23 @@
 #include <iostream>
 #include <bit>
+#include <array>
 
 #include "d_heap.h"
 
+// Built at compile time, lives in .rodata
+constexpr auto kSorted = [] {
+    fast_containers::MinDHeap<std::int32_t, 16> heap{};
+    for (std::int32_t i : {5, 3, 9, 1, 7}) {
+        heap.Insert(i);
+    }
+    std::array<std::int32_t, 5> sorted{};
+    for (auto& i : sorted) {
+        heap.Pop(i);
+    }
+    return sorted;
+}();
+static_assert(kSorted == std::array<std::int32_t, 5>{1, 3, 5, 7, 9});
+
 int main() {
     const std::size_t capacity = 18;
 
@@ -0,0 +1,53 @@
+#include <cassert>
+#include <memory>
+#include <string>
+
+#include "inplace_function.h"
+
+namespace {
+
+    struct Fill {
+        uint64_t price;
+        uint64_t quantity;
+        uint64_t order_id;
+    };
+
+}
+
+int main() {
+    uint64_t total = 0;
+
+    // Capture of 32 bytes does not fit into std::function small buffer, but fits into InplaceFunction
+    Fill last_fill{100, 5, 42};
+    fast_containers::InplaceFunction<void(const Fill&), 32> on_fill = [&total, last_fill](const Fill& fill) {
+        total += fill.price * fill.quantity + last_fill.order_id;
+    };
+    on_fill(Fill{10, 2, 1});
+    assert(total == 62);
+
+    auto copy = on_fill;
+    copy(Fill{1, 1, 1});
+    assert(total == 105);
+
+    fast_containers::InplaceFunction<int(int)> square = [](int x) { return x * x; };
+    assert(square(7) == 49);
+    square = nullptr;
+    assert(!square);
+
+    // The result is discarded if the function returns void
+    fast_containers::InplaceFunction<void(int)> cancel = [&total](int x) { total -= x; return total; };
+    cancel(5);
+    assert(total == 100);
+
+    // Move-only callables
+    auto pointer = std::make_unique<std::string>("order");
+    fast_containers::InplaceMoveOnlyFunction<std::size_t()> size = [pointer = std::move(pointer)]() {
+        return pointer->size();
+    };
+    auto moved = std::move(size);
+    assert(!size);
+    assert(moved() == 5);
+
+    // fast_containers::InplaceFunction<void(), 8> too_big = [last_fill]() {}; // Does not compile
+    return 0;
+}
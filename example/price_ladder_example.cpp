@@ -0,0 +1,75 @@
+#include <cassert>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "price_ladder.h"
+
+namespace {
+
+    struct Order {
+        uint64_t client_id_;
+    };
+
+}
+
+int main() {
+    // 2^18 ticks of bids, the window is [10000, 10000 + 2^18). The ladder is large, so it is on the heap
+    using Bids = fast_containers::BidLadder<Order, 1u << 18, 1024>;
+    auto bids = std::make_unique<Bids>(10000);
+    assert(bids->Empty() && !bids->GetBestPrice());
+
+    const auto first = bids->Add(10100, 5, Order{1});
+    const auto second = bids->Add(10100, 3, Order{2});
+    const auto third = bids->Add(10050, 7, Order{3});
+    assert(bids->Size() == 3 && bids->Get(second)->client_id_ == 2);
+
+    // The best bid is the highest price, the next one is lower
+    assert(*bids->GetBestPrice() == 10100 && *bids->GetNextPrice(10100) == 10050);
+    assert(!bids->GetNextPrice(10050));
+
+    const auto level = bids->GetLevel(10100);
+    assert(level.quantity_ == 8 && level.orders_count_ == 2 && bids->Front(10100) == first);
+
+    // Prices outside the window are rejected
+    bool is_rejected = false;
+    try {
+        bids->Add(9999, 1, Order{4});
+    } catch (const std::out_of_range&) {
+        is_rejected = true;
+    }
+    assert(is_rejected);
+
+    // Partial fill keeps the time priority, the full one removes the order
+    bids->Reduce(first, 2);
+    assert(bids->Front(10100) == first && bids->GetQuantity(first) == 3);
+    bids->Reduce(first, 3);
+    assert(!bids->Contains(first) && bids->Front(10100) == second);
+
+    // Orders of the level in the time priority
+    std::vector<uint64_t> clients;
+    bids->Add(10100, 1, Order{5});
+    bids->ForEachOrder(10100, [&clients](fast_containers::OrderId, uint64_t, Order& order) {
+        clients.push_back(order.client_id_);
+    });
+    assert((clients == std::vector<uint64_t>{2, 5}));
+
+    // The prices drift up, the window moves up and the levels move down in the array
+    assert(bids->Recenter(10040));
+    assert(bids->GetMinPrice() == 10040 && *bids->GetBestPrice() == 10100);
+    assert(bids->GetLevel(10100).quantity_ == 4 && bids->GetLevel(10050).quantity_ == 7);
+
+    // And back down, the levels move up in the array
+    assert(bids->Recenter(5000));
+    assert(bids->GetMinPrice() == 5000 && *bids->GetNextPrice(10100) == 10050);
+    assert(bids->Front(10050) == third && bids->Front(10100) == second);
+
+    // The window that leaves out an order is refused and the old one is kept
+    assert(!bids->Recenter(10060) && bids->GetMinPrice() == 5000);
+
+    // Cancel by id is O(1), the stale id is rejected
+    assert(bids->Cancel(third) && !bids->Cancel(third));
+    assert(bids->Recenter(10060) && *bids->GetBestPrice() == 10100 && !bids->GetNextPrice(10100));
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <cassert>
+#include <memory>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "id_object_pool.h"
+#include "d_heap.h"
+#include "mapped_file_storage.h"
+
+namespace {
+
+    using fast_containers::allocators::MappedFileAccess;
+    using fast_containers::allocators::SharedMemoryStoragePolicy;
+
+    struct Instrument : fast_containers::IdObjectPoolElementBase {
+        Instrument(uint64_t symbol, uint64_t tick_size) : symbol_(symbol), tick_size_(tick_size) {}
+
+        uint64_t symbol_;
+        uint64_t tick_size_;
+    };
+
+    using Instruments = fast_containers::IdObjectPool<Instrument, 1024, SharedMemoryStoragePolicy>;
+    using Deadlines = fast_containers::MinDHeap<uint64_t, 1024, 16, SharedMemoryStoragePolicy>;
+
+    inline constexpr const char* kInstrumentsName = "/fast_containers_instruments";
+    inline constexpr const char* kDeadlinesName = "/fast_containers_deadlines";
+    inline constexpr uint32_t kSchemaVersion = 1;
+
+}
+
+int main() {
+    // The feed handler owns the containers
+    auto instruments = std::make_unique<Instruments>(kInstrumentsName, kSchemaVersion);
+    auto deadlines = std::make_unique<Deadlines>(kDeadlinesName, kSchemaVersion);
+
+    const auto id = instruments->Construct(42, 5);
+    deadlines->Insert(1000);
+    deadlines->Insert(500);
+
+    // The strategy maps the same pages read-only
+    pid_t pid = fork();
+    if (pid == 0) {
+        Instruments reader{kInstrumentsName, kSchemaVersion, MappedFileAccess::kReader};
+        Deadlines deadlines_reader{kDeadlinesName, kSchemaVersion, MappedFileAccess::kReader};
+
+        uint64_t tick_size = 0;
+        const bool read = reader.TryRead(id, [&](const Instrument& instrument) {
+            tick_size = instrument.tick_size_;
+        });
+        uint64_t deadline = 0;
+        const bool has_top = deadlines_reader.TryTop(deadline);
+        _exit(read && tick_size == 5 && has_top && deadline == 500 ? 0 : 1);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    instruments.reset();
+    deadlines.reset();
+    fast_containers::allocators::RemoveSharedMemory(kInstrumentsName);
+    fast_containers::allocators::RemoveSharedMemory(kDeadlinesName);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <limits>
+#include <cassert>
+#include <cstdint>
+
+#include "inplace_sorted_map.h"
+#include "inplace_string.h"
+
+namespace {
+
+    struct Level {
+        uint64_t quantity_;
+        uint32_t orders_count_;
+    };
+
+}
+
+int main() {
+    // Price levels of the book, the keys are searched with SIMD
+    fast_containers::InplaceSortedMap<int32_t, Level, 256> levels;
+    assert(levels.Empty() && levels.GetCapacity() == 256);
+
+    assert(levels.InsertSorted(10100, Level{5, 1}));
+    assert(levels.InsertSorted(10050, Level{7, 2}));
+    assert(levels.InsertSorted(10200, Level{1, 1}));
+    assert(!levels.InsertSorted(10100, Level{0, 0}) && levels.Find(10100)->quantity_ == 5);
+
+    levels.InsertOrAssign(10100, Level{8, 2});
+    assert(levels.Size() == 3 && levels.Find(10100)->quantity_ == 8 && !levels.Find(10000));
+
+    // Keys are sorted, the bounds are the indexes
+    assert(levels.GetKey(0) == 10050 && levels.GetKey(2) == 10200);
+    assert(levels.LowerBound(10100) == 1 && levels.UpperBound(10100) == 2 && levels.LowerBound(20000) == 3);
+
+    uint64_t quantity = 0;
+    levels.ForEach(10000, 10200, [&quantity](const int32_t&, Level& level) { quantity += level.quantity_; });
+    assert(quantity == 15);
+
+    assert(levels.Erase(10050) && !levels.Erase(10050));
+    levels.EraseAt(0);
+    assert(levels.Size() == 1 && levels.GetKey(0) == 10200);
+
+    // The unused keys are the maximum value, so the maximum is the ordinary key
+    constexpr int32_t kMaxPrice = std::numeric_limits<int32_t>::max();
+    assert(!levels.Contains(kMaxPrice) && levels.LowerBound(kMaxPrice) == 1);
+    assert(levels.InsertSorted(kMaxPrice, Level{3, 1}));
+    assert(levels.Contains(kMaxPrice) && levels.Find(kMaxPrice)->quantity_ == 3);
+    assert(levels.LowerBound(kMaxPrice) == 1 && levels.UpperBound(kMaxPrice) == 2);
+    assert(levels.Erase(kMaxPrice) && !levels.Contains(kMaxPrice) && levels.Size() == 1);
+
+    // The same for 8 bytes unsigned keys, the full map has no unused keys at all
+    constexpr uint64_t kMaxId = std::numeric_limits<uint64_t>::max();
+    fast_containers::InplaceSortedMap<uint64_t, uint32_t, 16> orders;
+    for (uint64_t i = 0; i < 15; i++) {
+        orders.InsertSorted(i * 10, uint32_t(i));
+    }
+    assert(!orders.Contains(kMaxId));
+    assert(orders.InsertSorted(kMaxId, 42) && orders.Size() == 16);
+    assert(*orders.Find(kMaxId) == 42 && orders.GetKeys().back() == kMaxId);
+    assert(orders.LowerBound(kMaxId) == 15 && orders.UpperBound(kMaxId - 1) == 15);
+
+    bool is_exceeded = false;
+    try {
+        orders.InsertSorted(5, 0);
+    } catch (const std::length_error&) {
+        is_exceeded = true;
+    }
+    assert(is_exceeded);
+
+    // Other keys are found by the binary search
+    fast_containers::InplaceSortedMap<fast_containers::InplaceString<15>, uint32_t, 64> symbols;
+    symbols.InsertSorted("MSFT", 2);
+    symbols.InsertSorted("AAPL", 1);
+    assert(symbols.GetKey(0).View() == "AAPL" && *symbols.Find("MSFT") == 2 && !symbols.Contains("IBM"));
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <cassert>
+#include <thread>
+#include <cstdint>
+
+#include "spsc_queue.h"
+
+namespace {
+
+    enum MessageTypes : fast_containers::MessageType {
+        kTrade = 1,
+        kQuote = 2,
+    };
+
+    struct Trade {
+        uint64_t price;
+        uint64_t quantity;
+    };
+
+    struct Quote {
+        uint64_t bid;
+        uint64_t ask;
+        uint32_t venue;
+    };
+
+    inline constexpr uint64_t kMessagesCount = 100000;
+
+}
+
+int main() {
+    fast_containers::SpscQueue<1024> queue{};
+
+    std::thread producer([&queue]() {
+        for (uint64_t i = 0; i < kMessagesCount; i++) {
+            if (i % 2) {
+                while (!queue.TryPush(kTrade, Trade{i, 1})) {}
+            } else {
+                while (!queue.TryPush(kQuote, Quote{i, i + 1, 7})) {}
+            }
+        }
+    });
+
+    uint64_t received = 0;
+    while (received < kMessagesCount) {
+        received += queue.ConsumeAll([](const auto& message) {
+            if (message.type_ == kTrade) {
+                assert(message.payload_.template Get<Trade>().price % 2 == 1);
+            } else {
+                assert(message.type_ == kQuote);
+                assert(message.payload_.template Get<Quote>().venue == 7);
+            }
+        });
+    }
+    producer.join();
+    assert(queue.Empty());
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <cassert>
+#include <string>
+#include <unordered_set>
+
+#include "inplace_string.h"
+#include "inplace_any.h"
+
+int main() {
+    using Symbol = fast_containers::InplaceString<32>;
+    static_assert(std::is_trivially_copyable_v<Symbol>);
+
+    Symbol a = "AAPL";
+    assert(a.Size() == 4);
+    assert(a.View() == "AAPL");
+
+    Symbol b{a};
+    assert(a == b);
+
+    b.PushBack('X');
+    assert(a != b);
+    assert(a < b);
+    assert(b.View() == "AAPLX");
+
+    b.PopBack();
+    assert(a == b);
+    assert(a.Hash() == b.Hash());
+
+    Symbol c = "MSFT";
+    assert(a < c);
+    assert(c > b);
+
+    Symbol empty{};
+    assert(empty.Empty());
+    assert(empty < a);
+
+    c.Append(".O");
+    assert(c.View() == "MSFT.O");
+
+    std::unordered_set<Symbol> symbols{a, b, c};
+    assert(symbols.size() == 2);
+
+    fast_containers::InplaceTrivialAny<sizeof(Symbol), alignof(Symbol)> any = a;
+    assert(any.Get<Symbol>() == a);
+    return 0;
+}
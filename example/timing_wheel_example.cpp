@@ -0,0 +1,64 @@
+#include <cassert>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "timing_wheel.h"
+
+namespace {
+
+    struct Timeout {
+        uint64_t order_id_;
+        uint64_t deadline_;
+    };
+
+}
+
+int main() {
+    // Ticks are milliseconds, the wheel starts at 1000 ms
+    using Timeouts = fast_containers::TimingWheel<Timeout, 1024>;
+    auto timeouts = std::make_unique<Timeouts>(1000);
+    assert(timeouts->Empty() && timeouts->GetCurrentTick() == 1000);
+
+    const auto late = timeouts->Schedule(1500, Timeout{3, 1500});
+    const auto cancelled = timeouts->Schedule(1200, Timeout{2, 1200});
+    timeouts->Schedule(1100, Timeout{1, 1100});
+    // Far beyond the horizon of the levels, waits in the overflow list
+    timeouts->Schedule(uint64_t(1) << 40, Timeout{4, uint64_t(1) << 40});
+    assert(timeouts->Size() == 4 && timeouts->Get(late)->order_id_ == 3);
+
+    // The order is filled, its timeout is not needed anymore, the stale id is rejected
+    assert(timeouts->Cancel(cancelled));
+    assert(!timeouts->Cancel(cancelled) && !timeouts->Contains(cancelled));
+
+    // Nothing is due yet, the idle ticks are skipped
+    std::vector<uint64_t> fired;
+    auto handler = [&fired](Timeout& timeout) { fired.push_back(timeout.order_id_); };
+    assert(timeouts->Advance(1099, handler) == 0 && timeouts->GetCurrentTick() == 1100);
+
+    // Timers fire in the deadline order, the fired ids are not valid anymore
+    assert(timeouts->Advance(2000, handler) == 2);
+    assert((fired == std::vector<uint64_t>{1, 3}) && !timeouts->Contains(late));
+
+    // The deadline in the past fires on the next Advance
+    timeouts->Schedule(10, Timeout{5, 10});
+    assert(timeouts->Advance(timeouts->GetCurrentTick(), handler) == 1 && fired.back() == 5);
+
+    // The handler may reschedule, the retries due before now fire in the same call
+    std::size_t retries = 0;
+    timeouts->Schedule(2100, Timeout{6, 2100});
+    const std::size_t count = timeouts->Advance(2500, [&](Timeout& timeout) {
+        if (++retries < 3) {
+            timeouts->Schedule(timeout.deadline_ + 100, Timeout{timeout.order_id_, timeout.deadline_ + 100});
+        }
+    });
+    assert(count == 3 && retries == 3);
+
+    // The overflow timer is still waiting
+    assert(timeouts->Size() == 1);
+    fired.clear();
+    assert(timeouts->Advance(uint64_t(1) << 40, handler) == 1 && fired.back() == 4);
+    assert(timeouts->Empty());
+
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <cassert>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <numeric>
+
+#include "inplace_vector.h"
+#include "stack_allocator.h"
+
+namespace {
+
+    struct Fill {
+        uint64_t price_;
+        uint64_t quantity_;
+    };
+
+    struct Leg {
+        std::string symbol_;
+        int64_t ratio_;
+    };
+
+}
+
+int main() {
+    // Fills of one execution never allocate, the vector is trivially destructible
+    using Fills = fast_containers::InplaceVector<Fill, 8>;
+    static_assert(std::is_trivially_destructible_v<Fills>);
+
+    Fills fills{Fill{100, 5}, Fill{101, 3}};
+    fills.PushBack(Fill{102, 2});
+    fills.Insert(fills.begin(), Fill{99, 1});
+    assert(fills.Size() == 4 && fills.Front().price_ == 99);
+
+    const auto quantity = std::accumulate(fills.begin(), fills.end(), uint64_t(0),
+                                          [](uint64_t sum, const Fill& fill) { return sum + fill.quantity_; });
+    assert(quantity == 11);
+
+    fills.Erase(fills.begin() + 1);
+    assert(fills.Size() == 3 && fills[1].price_ == 101);
+
+    // Copies are one std::memcpy of the used elements
+    Fills copy = fills;
+    assert(copy.Size() == fills.Size() && copy.Back().price_ == 102);
+
+    fills.Resize(8);
+    bool is_exceeded = false;
+    try {
+        fills.PushBack(Fill{103, 1});
+    } catch (const std::length_error&) {
+        is_exceeded = true;
+    }
+    assert(is_exceeded);
+
+    // Rare large orders overflow to the stack based memory resource instead of the heap
+    using Resource = fast_containers::allocators::StackBasedMemoryResource<Leg, 1024>;
+    using Legs = fast_containers::InplaceVector<Leg, 2, Resource::Allocator<Leg>>;
+    auto resource = std::make_unique<Resource>();
+
+    Legs legs{*resource};
+    legs.EmplaceBack("ESZ6", 1);
+    legs.EmplaceBack("ESH7", -1);
+    assert(legs.IsInplace());
+
+    legs.EmplaceBack("ESM7", 1);
+    assert(!legs.IsInplace() && legs.Capacity() >= 3);
+
+    legs.PopBack();
+    legs.ShrinkToFit();
+    assert(legs.IsInplace() && legs.Back().symbol_ == "ESH7");
+
+    return 0;
+}
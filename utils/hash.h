@@ -0,0 +1,202 @@
+#ifndef FAST_CONTAINERS_HASH_H
+#define FAST_CONTAINERS_HASH_H
+
+#include <bit>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <concepts>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
+namespace fast_containers::utils {
+
+    namespace details::hash {
+
+        inline constexpr uint64_t kGoldenRatio = 0x9e3779b97f4a7c15ull;
+
+        inline constexpr uint64_t kFmixFirstMultiplier = 0xff51afd7ed558ccdull;
+        inline constexpr uint64_t kFmixSecondMultiplier = 0xc4ceb9fe1a85ec53ull;
+
+        inline constexpr std::array<uint64_t, 4> kWySecret{0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+                                                           0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+        inline constexpr uint32_t kCrc32cPolynomial = 0x82f63b78u;
+        inline constexpr uint32_t kCrc32cHighSeed = 0x2545f491u;
+
+        inline uint64_t Read64(const char* pointer) noexcept {
+            uint64_t result;
+            std::memcpy(&result, pointer, sizeof(result));
+            return result;
+        }
+
+        inline uint64_t Read32(const char* pointer) noexcept {
+            uint32_t result;
+            std::memcpy(&result, pointer, sizeof(result));
+            return result;
+        }
+
+        // Reads 1-3 bytes without branches on the exact size
+        inline uint64_t ReadSmall(const char* pointer, std::size_t size) noexcept {
+            return (uint64_t(static_cast<unsigned char>(pointer[0])) << 16u) |
+                   (uint64_t(static_cast<unsigned char>(pointer[size >> 1u])) << 8u) |
+                   uint64_t(static_cast<unsigned char>(pointer[size - 1u]));
+        }
+
+        // 64x64 -> 128 multiplication, returns low and high halves
+        inline void MultiplyFull(uint64_t& a, uint64_t& b) noexcept {
+            const __uint128_t result = __uint128_t(a) * b;
+            a = static_cast<uint64_t>(result);
+            b = static_cast<uint64_t>(result >> 64u);
+        }
+
+        inline uint64_t MultiplyFold(uint64_t a, uint64_t b) noexcept {
+            MultiplyFull(a, b);
+            return a ^ b;
+        }
+
+        constexpr std::array<uint32_t, 256> GetCrc32cTable() {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t crc = i;
+                for (int j = 0; j < 8; j++) {
+                    crc = (crc >> 1u) ^ (kCrc32cPolynomial & (0u - (crc & 1u)));
+                }
+                table[i] = crc;
+            }
+            return table;
+        }
+
+        inline constexpr std::array<uint32_t, 256> kCrc32cTable = GetCrc32cTable();
+
+        inline uint32_t Crc32cByte(uint32_t crc, unsigned char byte) noexcept {
+            return (crc >> 8u) ^ kCrc32cTable[(crc ^ byte) & 0xffu];
+        }
+
+    } // End of namespace fast_containers::utils::details::hash
+
+
+    // MurmurHash3 finalizer. Full avalanche, 2 multiplications
+    constexpr uint64_t Fmix64(uint64_t key) noexcept {
+        using namespace details::hash;
+        key ^= key >> 33u;
+        key *= kFmixFirstMultiplier;
+        key ^= key >> 33u;
+        key *= kFmixSecondMultiplier;
+        key ^= key >> 33u;
+        return key;
+    }
+
+    // Fibonacci hashing with a single xorshift, so the low bits also depend on the high bits of the key.
+    // Cheaper than Fmix64 but with a weaker avalanche
+    constexpr uint64_t MulXorShift(uint64_t key) noexcept {
+        key *= details::hash::kGoldenRatio;
+        return key ^ (key >> 32u);
+    }
+
+    // Hardware CRC32C (SSE4.2), falls back to the table implementation
+    inline uint32_t Crc32c(uint64_t key, uint32_t seed = 0) noexcept {
+#ifdef __SSE4_2__
+        return static_cast<uint32_t>(_mm_crc32_u64(seed, key));
+#else
+        uint32_t crc = seed;
+        for (int i = 0; i < 8; i++) {
+            crc = details::hash::Crc32cByte(crc, static_cast<unsigned char>(key >> (i * 8)));
+        }
+        return crc;
+#endif
+    }
+
+    inline uint32_t Crc32c(const void* data, std::size_t size, uint32_t seed = 0) noexcept {
+        auto pointer = static_cast<const char*>(data);
+        uint32_t crc = seed;
+        for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), pointer += sizeof(uint64_t)) {
+            crc = Crc32c(details::hash::Read64(pointer), crc);
+        }
+        for (; size; size--, pointer++) {
+#ifdef __SSE4_2__
+            crc = _mm_crc32_u8(crc, static_cast<unsigned char>(*pointer));
+#else
+            crc = details::hash::Crc32cByte(crc, static_cast<unsigned char>(*pointer));
+#endif
+        }
+        return crc;
+    }
+
+    // Two CRC32C lanes give a 64-bit hash, both instructions are executed in parallel. CRC is affine in its seed,
+    // so the high lane hashes the rotated and multiplied key, otherwise it would be the low lane xor a constant
+    inline uint64_t Crc32cHash(uint64_t key) noexcept {
+        using namespace details::hash;
+        const uint64_t high_key = std::rotl(key, 32) * kGoldenRatio;
+        return (uint64_t(Crc32c(high_key, kCrc32cHighSeed)) << 32u) | Crc32c(key);
+    }
+
+    // wyhash-style hash for short byte strings. Keys up to 16 bytes take a single 128-bit multiplication.
+    // If size is a compile time constant, all size branches are removed after inlining
+    inline uint64_t WyHash(const void* data, std::size_t size, uint64_t seed = 0) noexcept {
+        using namespace details::hash;
+        auto pointer = static_cast<const char*>(data);
+        seed ^= MultiplyFold(seed ^ kWySecret[0], kWySecret[1]);
+
+        uint64_t a;
+        uint64_t b;
+        if (size <= 16u) {
+            if (size >= 4u) {
+                const std::size_t shift = (size >> 3u) << 2u;
+                a = (Read32(pointer) << 32u) | Read32(pointer + shift);
+                b = (Read32(pointer + size - 4u) << 32u) | Read32(pointer + size - 4u - shift);
+            } else if (size > 0) {
+                a = ReadSmall(pointer, size);
+                b = 0;
+            } else {
+                a = b = 0;
+            }
+        } else {
+            std::size_t rest = size;
+            for (; rest > 16u; rest -= 16u, pointer += 16u) {
+                seed = MultiplyFold(Read64(pointer) ^ kWySecret[1], Read64(pointer + 8u) ^ seed);
+            }
+            a = Read64(pointer + rest - 16u);
+            b = Read64(pointer + rest - 8u);
+        }
+
+        a ^= kWySecret[1];
+        b ^= seed;
+        MultiplyFull(a, b);
+        return MultiplyFold(a ^ kWySecret[0] ^ size, b ^ kWySecret[1]);
+    }
+
+
+    template<typename Key>
+    concept HasHashMethod = requires(const Key& key) {
+        { key.Hash() } -> std::convertible_to<std::size_t>;
+    };
+
+    // Default hash for the containers. Chooses the hash function by the key type:
+    // integers and pointers - Fmix64, types with Hash() method - Hash(), byte strings - WyHash, others - std::hash
+    template<typename Key>
+    struct Hash {
+        std::size_t operator()(const Key& key) const noexcept {
+            if constexpr ((std::is_integral_v<Key> || std::is_enum_v<Key>) && sizeof(Key) <= sizeof(uint64_t)) {
+                return Fmix64(static_cast<uint64_t>(key));
+            } else if constexpr (std::is_pointer_v<Key>) {
+                return Fmix64(reinterpret_cast<uintptr_t>(key));
+            } else if constexpr (HasHashMethod<Key>) {
+                return key.Hash();
+            } else if constexpr (std::is_convertible_v<const Key&, std::string_view>) {
+                const std::string_view view = key;
+                return WyHash(view.data(), view.size());
+            } else {
+                return std::hash<Key>{}(key);
+            }
+        }
+    };
+
+} // End of namespace fast_containers::utils
+
+#endif //FAST_CONTAINERS_HASH_H
@@ -0,0 +1,227 @@
+#ifndef FAST_CONTAINERS_PERF_COUNTERS_H
+#define FAST_CONTAINERS_PERF_COUNTERS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+namespace fast_containers::utils {
+
+    enum class PerfEvent : std::size_t {
+        kCycles,
+        kInstructions,
+        kBranchMisses,
+        kL1DMisses,  // L1 data cache read misses
+        kLlcMisses,  // Last level cache read misses
+        kDtlbMisses, // Data TLB read misses
+    };
+
+    inline constexpr std::size_t kPerfEventsCount = 6;
+
+    const char* ToString(PerfEvent event) noexcept;
+
+    // Counter values of the measured region, scaled if the kernel multiplexed the counters
+    struct PerfCountersSnapshot {
+        std::array<uint64_t, kPerfEventsCount> values_{};
+        std::array<bool, kPerfEventsCount> available_{};
+
+        [[nodiscard]] uint64_t Get(PerfEvent event) const noexcept;
+        [[nodiscard]] bool IsAvailable(PerfEvent event) const noexcept;
+
+        // Instructions per cycle, 0 if any of the counters is not available
+        [[nodiscard]] double GetIpc() const noexcept;
+    };
+
+    // perf_event_open counters of the calling thread, user space only.
+    // Every event is opened separately, so an event the CPU, the VM or perf_event_paranoid does not allow is just
+    // not available and the others still work. If nothing is available Start() and Stop() do nothing
+    class PerfCounters {
+    public:
+        PerfCounters() noexcept;
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters(PerfCounters&&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+        PerfCounters& operator=(PerfCounters&&) = delete;
+
+        // Resets and enables the counters
+        void Start() noexcept;
+
+        // Disables the counters and reads them
+        PerfCountersSnapshot Stop() noexcept;
+
+        [[nodiscard]] bool IsAvailable(PerfEvent event) const noexcept;
+        [[nodiscard]] bool IsAnyAvailable() const noexcept;
+
+        ~PerfCounters();
+
+    private:
+        std::array<int, kPerfEventsCount> descriptors_;
+    };
+
+    // Collects the counters of the scope into the snapshot
+    class ScopedPerfRegion {
+    public:
+        ScopedPerfRegion(PerfCounters& counters, PerfCountersSnapshot& snapshot) noexcept;
+
+        ScopedPerfRegion(const ScopedPerfRegion&) = delete;
+        ScopedPerfRegion& operator=(const ScopedPerfRegion&) = delete;
+
+        ~ScopedPerfRegion();
+
+    private:
+        PerfCounters& counters_;
+        PerfCountersSnapshot& snapshot_;
+    };
+
+
+    // Implementation
+    namespace details::perf_counters {
+
+        inline constexpr uint64_t GetCacheConfig(uint64_t cache, uint64_t result) noexcept {
+            return cache | (uint64_t(PERF_COUNT_HW_CACHE_OP_READ) << 8u) | (result << 16u);
+        }
+
+        inline constexpr std::array<std::pair<uint32_t, uint64_t>, kPerfEventsCount> kEventConfigs{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, GetCacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+            {PERF_TYPE_HW_CACHE, GetCacheConfig(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+            {PERF_TYPE_HW_CACHE, GetCacheConfig(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+        }};
+
+        // Value, time enabled and time running
+        struct ReadFormat {
+            uint64_t value_;
+            uint64_t enabled_;
+            uint64_t running_;
+        };
+
+        inline int Open(uint32_t type, uint64_t config) noexcept {
+            perf_event_attr attributes{};
+            attributes.size = sizeof(attributes);
+            attributes.type = type;
+            attributes.config = config;
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        }
+
+    } // End of namespace fast_containers::utils::details::perf_counters
+
+    inline const char* ToString(PerfEvent event) noexcept {
+        switch (event) {
+            case PerfEvent::kCycles:
+                return "cycles";
+            case PerfEvent::kInstructions:
+                return "instructions";
+            case PerfEvent::kBranchMisses:
+                return "branch-misses";
+            case PerfEvent::kL1DMisses:
+                return "L1D-misses";
+            case PerfEvent::kLlcMisses:
+                return "LLC-misses";
+            case PerfEvent::kDtlbMisses:
+                return "dTLB-misses";
+        }
+        return "unknown";
+    }
+
+    // PerfCountersSnapshot
+    inline uint64_t PerfCountersSnapshot::Get(PerfEvent event) const noexcept {
+        return values_[std::size_t(event)];
+    }
+
+    inline bool PerfCountersSnapshot::IsAvailable(PerfEvent event) const noexcept {
+        return available_[std::size_t(event)];
+    }
+
+    inline double PerfCountersSnapshot::GetIpc() const noexcept {
+        if (!IsAvailable(PerfEvent::kCycles) || !IsAvailable(PerfEvent::kInstructions) || !Get(PerfEvent::kCycles)) {
+            return 0.0;
+        }
+        return double(Get(PerfEvent::kInstructions)) / double(Get(PerfEvent::kCycles));
+    }
+
+    // PerfCounters
+    inline PerfCounters::PerfCounters() noexcept {
+        using details::perf_counters::kEventConfigs;
+        for (std::size_t i = 0; i < kPerfEventsCount; i++) {
+            descriptors_[i] = details::perf_counters::Open(kEventConfigs[i].first, kEventConfigs[i].second);
+        }
+    }
+
+    inline void PerfCounters::Start() noexcept {
+        for (auto descriptor : descriptors_) {
+            if (descriptor >= 0) {
+                ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+                ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    inline PerfCountersSnapshot PerfCounters::Stop() noexcept {
+        for (auto descriptor : descriptors_) {
+            if (descriptor >= 0) {
+                ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+
+        PerfCountersSnapshot snapshot;
+        for (std::size_t i = 0; i < kPerfEventsCount; i++) {
+            details::perf_counters::ReadFormat result{};
+            if (descriptors_[i] < 0 || read(descriptors_[i], &result, sizeof(result)) != sizeof(result)) {
+                continue;
+            }
+            // The counter was multiplexed with the others and was running only part of the time
+            if (result.running_ && result.running_ < result.enabled_) {
+                result.value_ = uint64_t(double(result.value_) * double(result.enabled_) / double(result.running_));
+            }
+            snapshot.values_[i] = result.value_;
+            snapshot.available_[i] = true;
+        }
+        return snapshot;
+    }
+
+    inline bool PerfCounters::IsAvailable(PerfEvent event) const noexcept {
+        return descriptors_[std::size_t(event)] >= 0;
+    }
+
+    inline bool PerfCounters::IsAnyAvailable() const noexcept {
+        for (auto descriptor : descriptors_) {
+            if (descriptor >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline PerfCounters::~PerfCounters() {
+        for (auto descriptor : descriptors_) {
+            if (descriptor >= 0) {
+                close(descriptor);
+            }
+        }
+    }
+
+    // ScopedPerfRegion
+    inline ScopedPerfRegion::ScopedPerfRegion(PerfCounters& counters, PerfCountersSnapshot& snapshot) noexcept
+            : counters_(counters), snapshot_(snapshot) {
+        counters_.Start();
+    }
+
+    inline ScopedPerfRegion::~ScopedPerfRegion() {
+        snapshot_ = counters_.Stop();
+    }
+
+} // End of namespace fast_containers::utils
+
+#endif //FAST_CONTAINERS_PERF_COUNTERS_H